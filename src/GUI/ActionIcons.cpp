@@ -0,0 +1,81 @@
+/*
+ This file is part of Venturous.
+ Copyright (C) 2026 Igor Kushnir <igorkuo AT Google mail>
+
+ Venturous is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Venturous is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ Venturous.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# include "ActionIcons.hpp"
+
+# include "Icons.hpp"
+
+# include <QList>
+# include <QEvent>
+# include <QAction>
+# include <QWidget>
+# include <QMenu>
+# include <QToolBar>
+
+
+namespace Icons
+{
+ActionIcons::ActionIcons(const Theme & theme, QObject * const parent)
+    : QObject(parent), theme_(theme)
+{
+}
+
+QAction * ActionIcons::add(QAction * const action, const Getter getter)
+{
+    pending_[action] = getter;
+    return action;
+}
+
+void ActionIcons::watchWidgets()
+{
+    for (const auto & p : pending_) {
+        for (QWidget * const widget : p.first->associatedWidgets()) {
+            if (qobject_cast<QMenu *>(widget) != nullptr ||
+                    qobject_cast<QToolBar *>(widget) != nullptr) {
+                // Installing the same filter again does not duplicate it.
+                widget->installEventFilter(this);
+            }
+        }
+    }
+}
+
+bool ActionIcons::eventFilter(QObject * const watched, QEvent * const event)
+{
+    // Menus are laid out again when icons of their actions change, so setting
+    // icons on Show event is early enough. Only menus and tool bars are
+    // watched, see watchWidgets().
+    if (event->type() == QEvent::Show) {
+        watched->removeEventFilter(this);
+        setIcons(static_cast<QWidget *>(watched)->actions());
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+
+void ActionIcons::setIcons(const QList<QAction *> & actions)
+{
+    for (QAction * const action : actions) {
+        const auto it = pending_.find(action);
+        if (it != pending_.end()) {
+            action->setIcon((theme_.*(it->second))());
+            pending_.erase(it);
+        }
+    }
+}
+
+} // END namespace Icons
@@ -0,0 +1,79 @@
+/*
+ This file is part of Venturous.
+ Copyright (C) 2026 Igor Kushnir <igorkuo AT Google mail>
+
+ Venturous is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Venturous is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ Venturous.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef VENTUROUS_ACTION_ICONS_HPP
+# define VENTUROUS_ACTION_ICONS_HPP
+
+# include <QtGlobal>
+# include <QList>
+# include <QObject>
+
+# include <unordered_map>
+
+
+QT_FORWARD_DECLARE_CLASS(QIcon)
+QT_FORWARD_DECLARE_CLASS(QAction)
+QT_FORWARD_DECLARE_CLASS(QEvent)
+
+namespace Icons
+{
+class Theme;
+
+/// Sets icons of actions the first time a menu or tool bar that contains them
+/// is shown, so that icons of actions that are never displayed are not
+/// resolved at all. Each menu and tool bar is watched only until it is shown
+/// for the first time. Icons of actions in menus that are not shown as
+/// widgets must be set explicitly with setIcons().
+class ActionIcons : public QObject
+{
+public:
+    typedef const QIcon & (Theme::* Getter)() const;
+
+    /// NOTE: theme must remain valid throughout this ActionIcons' lifetime.
+    explicit ActionIcons(const Theme & theme, QObject * parent = nullptr);
+
+    /// @brief Makes action receive the icon returned by getter when it is
+    /// about to be displayed.
+    /// NOTE: action must not be destroyed before this ActionIcons.
+    /// @return action.
+    QAction * add(QAction * action, Getter getter);
+
+    /// @brief Starts watching menus and tool bars that contain actions, icons
+    /// of which have not been set yet.
+    /// NOTE: should be called after pending actions are added to new menus or
+    /// tool bars. Actions are added to menus after add() is called, so this
+    /// can not be done by add() itself.
+    void watchWidgets();
+
+    /// @brief Sets icons of pending actions from actions immediately.
+    /// Should be used for menus that are not necessarily shown as widgets,
+    /// e.g. notification area icon menu, which can be exported over D-Bus.
+    void setIcons(const QList<QAction *> & actions);
+
+protected:
+    bool eventFilter(QObject * watched, QEvent * event) override;
+
+private:
+    const Theme & theme_;
+    /// Actions, icons of which have not been set yet.
+    std::unordered_map<QAction *, Getter> pending_;
+};
+
+}
+
+# endif // VENTUROUS_ACTION_ICONS_HPP
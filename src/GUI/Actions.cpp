@@ -18,25 +18,27 @@
 
 # include "Actions.hpp"
 
+# include "ActionIcons.hpp"
 # include "Icons.hpp"
 
 # include <QAction>
 # include <QKeySequence>
 
 
-Actions::Actions(const Icons::Theme & theme)
-    : file(theme), playback(theme), playlist(theme), help(theme),
-      addingPolicy(theme)
+Actions::Actions(Icons::ActionIcons & icons)
+    : file(icons), playback(icons), playlist(icons), help(icons),
+      addingPolicy(icons)
 {
 }
 
 
-Actions::File::File(const Icons::Theme & theme)
-    : preferences(new QAction(theme.preferences(),
-                              tr("&Preferences ..."), this)),
+Actions::File::File(Icons::ActionIcons & icons)
+    : preferences(icons.add(new QAction(tr("&Preferences ..."), this),
+                            & Icons::Theme::preferences)),
     /// TODO: add icon (places/folder).
     preferencesDirectory(new QAction(tr("Preferences &directory"), this)),
-    quit(new QAction(theme.quit(), tr("&Quit"), this))
+    quit(icons.add(new QAction(tr("&Quit"), this),
+                   & Icons::Theme::quit))
 {
     preferences->setIconText("Pf");
     preferences->setToolTip(tr("Show preferences window"));
@@ -50,29 +52,40 @@ Actions::File::File(const Icons::Theme & theme)
 Actions::File::~File() = default;
 
 
-Actions::Playback::Playback(const Icons::Theme & theme)
-    : play(new QAction(theme.playbackPlay(), tr("&Play"), this)),
-      pause(new QAction(theme.playbackPause(), tr("Pa&use"), this)),
-      stop(new QAction(theme.playbackStop(), tr("&Stop"), this)),
-      previous(new QAction(theme.playbackPrevious(), tr("Pre&vious"), this)),
-      replayLast(new QAction(theme.playbackReplayLast(),
-                             tr("Replay &last"), this)),
-      nextFromHistory(new QAction(theme.playbackNextFromHistory(),
-                                  tr("Next &from history"), this)),
-      nextRandom(new QAction(theme.playbackNextRandom(),
-                             tr("Next &random"), this)),
-      next(new QAction(theme.playbackNext(), tr("&Next"), this)),
-      playAll(new QAction(theme.playbackPlayAll(), tr("Play &all"), this)),
-      showExternalPlayerWindow(new QAction(theme.audioPlayerShow(),
-                                           tr("&Show window"), this)),
-      hideExternalPlayerWindow(new QAction(theme.audioPlayerHide(),
-                                           tr("&Hide window"), this)),
+Actions::Playback::Playback(Icons::ActionIcons & icons)
+    : play(icons.add(new QAction(tr("&Play"), this),
+                     & Icons::Theme::playbackPlay)),
+      pause(icons.add(new QAction(tr("Pa&use"), this),
+                      & Icons::Theme::playbackPause)),
+      stop(icons.add(new QAction(tr("&Stop"), this),
+                     & Icons::Theme::playbackStop)),
+      previous(icons.add(new QAction(tr("Pre&vious"), this),
+                         & Icons::Theme::playbackPrevious)),
+      replayLast(icons.add(new QAction(tr("Replay &last"), this),
+                           & Icons::Theme::playbackReplayLast)),
+      nextFromHistory(icons.add(new QAction(tr("Next &from history"), this),
+                                & Icons::Theme::playbackNextFromHistory)),
+      nextRandom(icons.add(new QAction(tr("Next &random"), this),
+                           & Icons::Theme::playbackNextRandom)),
+      next(icons.add(new QAction(tr("&Next"), this),
+                     & Icons::Theme::playbackNext)),
+      playAll(icons.add(new QAction(tr("Play &all"), this),
+                        & Icons::Theme::playbackPlayAll)),
+      playRandomBatch(icons.add(new QAction(tr("Play random &batch"), this),
+                                & Icons::Theme::playbackNextRandom)),
+      showExternalPlayerWindow(icons.add(new QAction(tr("&Show window"), this),
+                                         & Icons::Theme::audioPlayerShow)),
+      hideExternalPlayerWindow(icons.add(new QAction(tr("&Hide window"), this),
+                                         & Icons::Theme::audioPlayerHide)),
       setExternalPlayerOptions(new QAction(tr("Set &essential options"), this)),
-      updateStatus(new QAction(theme.viewRefresh(),
-                               tr("Up&date status"), this)),
-      importHistory(new QAction(theme.load(), tr("&Import ..."), this)),
-      exportHistory(new QAction(theme.saveAs(), tr("&Export ..."), this)),
-      clearHistory(new QAction(theme.clear(), tr("&Clear"), this))
+      updateStatus(icons.add(new QAction(tr("Up&date status"), this),
+                             & Icons::Theme::viewRefresh)),
+      importHistory(icons.add(new QAction(tr("&Import ..."), this),
+                              & Icons::Theme::load)),
+      exportHistory(icons.add(new QAction(tr("&Export ..."), this),
+                              & Icons::Theme::saveAs)),
+      clearHistory(icons.add(new QAction(tr("&Clear"), this),
+                             & Icons::Theme::clear))
 {
     play->setIconText("Pl");
     play->setShortcut(Qt::CTRL | Qt::Key_P);
@@ -91,6 +104,9 @@ Actions::Playback::Playback(const Icons::Theme & theme)
     next->setShortcut(Qt::CTRL | Qt::Key_N);
 
     playAll->setIconText("PA");
+    playRandomBatch->setIconText("RB");
+    playRandomBatch->setToolTip(
+        tr("Play several distinct random items at once"));
 
     {
         const QString externalPlayerWindow = tr(" external player window");
@@ -119,18 +135,28 @@ Actions::Playback::Playback(const Icons::Theme & theme)
 Actions::Playback::~Playback() = default;
 
 
-Actions::Playlist::Playlist(const Icons::Theme & theme)
-    : editMode(new QAction(theme.edit(), tr("&Edit mode"), this)),
-      applyChanges(new QAction(theme.apply(), tr("Apply changes"), this)),
-      cancelChanges(new QAction(theme.cancel(), tr("Cancel changes"), this)),
-      addFiles(new QAction(theme.add(), tr("Add &files ..."), this)),
-      addDirectory(new QAction(theme.addDir(), tr("Add &directory ..."), this)),
-      cleanUp(new QAction(theme.cleanUp(), tr("Clean &up"), this)),
-      clear(new QAction(theme.clear(), tr("&Clear"), this)),
-      restorePrevious(new QAction(
-                          theme.revert(), tr("&Restore previous"), this)),
-      load(new QAction(theme.load(), tr("&Load ..."), this)),
-      saveAs(new QAction(theme.saveAs(), tr("&Save as ..."), this))
+Actions::Playlist::Playlist(Icons::ActionIcons & icons)
+    : editMode(icons.add(new QAction(tr("&Edit mode"), this),
+                         & Icons::Theme::edit)),
+      applyChanges(icons.add(new QAction(tr("Apply changes"), this),
+                             & Icons::Theme::apply)),
+      cancelChanges(icons.add(new QAction(tr("Cancel changes"), this),
+                              & Icons::Theme::cancel)),
+      addFiles(icons.add(new QAction(tr("Add &files ..."), this),
+                         & Icons::Theme::add)),
+      addDirectory(icons.add(new QAction(tr("Add &directory ..."), this),
+                             & Icons::Theme::addDir)),
+      cleanUp(icons.add(new QAction(tr("Clean &up"), this),
+                        & Icons::Theme::cleanUp)),
+      clear(icons.add(new QAction(tr("&Clear"), this),
+                      & Icons::Theme::clear)),
+      restorePrevious(icons.add(new QAction(tr("&Restore previous"), this),
+                                & Icons::Theme::revert)),
+      load(icons.add(new QAction(tr("&Load ..."), this),
+                     & Icons::Theme::load)),
+      saveAs(icons.add(new QAction(tr("&Save as ..."), this),
+                       & Icons::Theme::saveAs)),
+      find(new QAction(tr("&Find"), this))
 {
     const QString playlistName = tr(" playlist");
     editMode->setCheckable(true);
@@ -150,14 +176,19 @@ Actions::Playlist::Playlist(const Icons::Theme & theme)
     load->setToolTip(tr("Load") + playlistName);
     saveAs->setIconText("SA");
     saveAs->setToolTip(tr("Save%1 as").arg(playlistName));
+    find->setIconText("Fi");
+    find->setToolTip(tr("Filter%1 by item name").arg(playlistName));
+    find->setShortcuts(QKeySequence::Find);
 }
 
 Actions::Playlist::~Playlist() = default;
 
 
-Actions::Help::Help(const Icons::Theme & theme)
-    : help(new QAction(theme.help(), tr("&Help ..."), this)),
-      about(new QAction(theme.about(), tr("&About ..."), this))
+Actions::Help::Help(Icons::ActionIcons & icons)
+    : help(icons.add(new QAction(tr("&Help ..."), this),
+                     & Icons::Theme::help)),
+      about(icons.add(new QAction(tr("&About ..."), this),
+                      & Icons::Theme::about))
 {
     help->setIconText("He");
     help->setShortcuts(QKeySequence::HelpContents);
@@ -167,15 +198,17 @@ Actions::Help::Help(const Icons::Theme & theme)
 Actions::Help::~Help() = default;
 
 
-Actions::AddingPolicy::AddingPolicy(const Icons::Theme & theme)
-    : audioFile(new QAction(theme.audioFile(),
-                            tr("Consider adding &files"), this)),
-    mediaDir(new QAction(theme.mediaDir(),
-                         tr("Consider adding media &directories"), this)),
-    bothAudioFile(new QAction(theme.bothAudioFile(),
-                              tr("If both, add files"), this)),
-    bothMediaDir(new QAction(theme.bothMediaDir(),
-                             tr("If both, add media directories"), this))
+Actions::AddingPolicy::AddingPolicy(Icons::ActionIcons & icons)
+    : audioFile(icons.add(new QAction(tr("Consider adding &files"), this),
+                          & Icons::Theme::audioFile)),
+    mediaDir(icons.add(new QAction(tr("Consider adding media &directories"),
+                                   this),
+                       & Icons::Theme::mediaDir)),
+    bothAudioFile(icons.add(new QAction(tr("If both, add files"), this),
+                            & Icons::Theme::bothAudioFile)),
+    bothMediaDir(icons.add(new QAction(tr("If both, add media directories"),
+                                       this),
+                           & Icons::Theme::bothMediaDir))
 {
     audioFile->setCheckable(true);
     audioFile->setIconText("cAF");
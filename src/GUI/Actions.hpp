@@ -25,19 +25,19 @@
 
 namespace Icons
 {
-class Theme;
+class ActionIcons;
 }
 QT_FORWARD_DECLARE_CLASS(QAction)
 
 /// NOTE: each action's parent is the class that contains it.
 /// For example: playAll's parent is playback.
 struct Actions {
-    explicit Actions(const Icons::Theme & theme);
+    explicit Actions(Icons::ActionIcons & icons);
 
     class File : public QObject
     {
     public:
-        explicit File(const Icons::Theme & theme);
+        explicit File(Icons::ActionIcons & icons);
         ~File() override;
         QAction * preferences, * preferencesDirectory, * quit;
     } file;
@@ -45,10 +45,11 @@ struct Actions {
     class Playback : public QObject
     {
     public:
-        explicit Playback(const Icons::Theme & theme);
+        explicit Playback(Icons::ActionIcons & icons);
         ~Playback() override;
         QAction * play, * pause, * stop, * previous, * replayLast,
-                * nextFromHistory, * nextRandom, * next, * playAll;
+                * nextFromHistory, * nextRandom, * next, * playAll,
+                * playRandomBatch;
         QAction * showExternalPlayerWindow, * hideExternalPlayerWindow,
                 * setExternalPlayerOptions, * updateStatus;
         QAction * importHistory, * exportHistory, * clearHistory;
@@ -57,18 +58,19 @@ struct Actions {
     class Playlist : public QObject
     {
     public:
-        explicit Playlist(const Icons::Theme & theme);
+        explicit Playlist(Icons::ActionIcons & icons);
         ~Playlist() override;
         QAction * editMode, * applyChanges, * cancelChanges;
         QAction * addFiles, * addDirectory, * cleanUp, * clear,
                 * restorePrevious;
         QAction * load, * saveAs;
+        QAction * find;
     } playlist;
 
     class Help : public QObject
     {
     public:
-        explicit Help(const Icons::Theme & theme);
+        explicit Help(Icons::ActionIcons & icons);
         ~Help() override;
         QAction * help, * about;
     } help;
@@ -76,7 +78,7 @@ struct Actions {
     class AddingPolicy : public QObject
     {
     public:
-        explicit AddingPolicy(const Icons::Theme & theme);
+        explicit AddingPolicy(Icons::ActionIcons & icons);
         ~AddingPolicy() override;
         /// @brief Must be called after audioFile's or mediaDir's checkState
         /// changes.
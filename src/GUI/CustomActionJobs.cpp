@@ -0,0 +1,269 @@
+/*
+ This file is part of Venturous.
+ Copyright (C) 2026 Igor Kushnir <igorkuo AT Google mail>
+
+ Venturous is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Venturous is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ Venturous.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifdef DEBUG_VENTUROUS_CUSTOM_ACTIONS
+# include <QtCoreUtilities/String.hpp>
+# include <iostream>
+# endif
+
+
+# include "CustomActionJobs.hpp"
+
+# include <QString>
+# include <QStringList>
+# include <QVariant>
+# include <QObject>
+# include <QProcess>
+# include <QThread>
+# include <QMessageBox>
+
+# include <cstddef>
+# include <utility>
+# include <algorithm>
+# include <vector>
+
+
+namespace
+{
+const char * const jobIdProperty = "jobId";
+const char * const commandIndexProperty = "commandIndex";
+
+bool isDone(const CustomActions::JobScheduler::Job & job)
+{
+    typedef CustomActions::JobScheduler::JobState JobState;
+    return job.state == JobState::finished || job.state == JobState::canceled;
+}
+
+std::size_t toMaxRunningCount(const unsigned maxParallel)
+{
+    if (maxParallel != 0)
+        return maxParallel;
+    return std::size_t(std::max(1, QThread::idealThreadCount()));
+}
+
+}
+
+
+namespace CustomActions
+{
+constexpr std::size_t JobScheduler::maxFinishedJobCount;
+
+JobScheduler::JobScheduler(QObject * const parent)
+    : QObject(parent), maxRunningCount_(toMaxRunningCount(0))
+{
+}
+
+JobScheduler::~JobScheduler()
+{
+    // Destroying QProcess kills the process. Long-running applications (file
+    // manager, media player) must survive quit just as they did when they were
+    // started detached, so their QProcess objects are leaked intentionally.
+    for (QProcess * const process : findChildren<QProcess *>()) {
+        if (process->state() != QProcess::NotRunning) {
+            process->disconnect(this);
+            process->setParent(nullptr);
+        }
+    }
+}
+
+void JobScheduler::setMaxParallel(const unsigned maxParallel)
+{
+    maxRunningCount_ = toMaxRunningCount(maxParallel);
+    startCommands();
+}
+
+void JobScheduler::add(QString actionText,
+                       std::vector<CommandTemplate::Command> commands,
+                       const bool cleanUpPlaylist)
+{
+    if (commands.empty())
+        return;
+# ifdef DEBUG_VENTUROUS_CUSTOM_ACTIONS
+    std::cout << "Adding custom action job with " << commands.size()
+              << " command(s): \"" << QtUtilities::qStringToString(actionText)
+              << "\"." << std::endl;
+# endif
+    removeOldFinished();
+    jobs_.push_back( { nextId_++, std::move(actionText), std::move(commands),
+                       cleanUpPlaylist, JobState::queued, 0, 0, QStringList()
+                     });
+    startCommands();
+    emit jobsChanged();
+}
+
+void JobScheduler::cancel(const JobId id)
+{
+    Job * const job = find(id);
+    if (job == nullptr || job->state == JobState::finished ||
+            job->state == JobState::canceled) {
+        return;
+    }
+    job->state = JobState::canceled;
+    for (QProcess * const process : findChildren<QProcess *>()) {
+        if (process->property(jobIdProperty).toUInt() == id)
+            process->kill();
+    }
+    finish(* job);
+    emit jobsChanged();
+}
+
+void JobScheduler::removeFinished()
+{
+    jobs_.erase(std::remove_if(jobs_.begin(), jobs_.end(), isDone),
+                jobs_.end());
+    emit jobsChanged();
+}
+
+
+void JobScheduler::removeOldFinished()
+{
+    const std::size_t finishedCount =
+        std::size_t(std::count_if(jobs_.cbegin(), jobs_.cend(), isDone));
+    if (finishedCount <= maxFinishedJobCount)
+        return;
+    std::size_t excess = finishedCount - maxFinishedJobCount;
+    // Jobs are ordered from oldest to newest.
+    jobs_.erase(std::remove_if(jobs_.begin(), jobs_.end(),
+    [&excess](const Job & job) {
+        if (excess == 0 || ! isDone(job))
+            return false;
+        --excess;
+        return true;
+    }), jobs_.end());
+}
+
+
+void JobScheduler::startCommands()
+{
+    // start() can finish a command synchronously if it fails to start.
+    // The freed slot is then taken by the loop below instead of a nested
+    // call.
+    if (startingCommands_)
+        return;
+    startingCommands_ = true;
+    for (Job & job : jobs_) {
+        if (job.state != JobState::queued && job.state != JobState::running)
+            continue;
+        while (runningCount_ < maxRunningCount_ &&
+                job.startedCount < job.commands.size()) {
+            start(job);
+        }
+        if (runningCount_ >= maxRunningCount_)
+            break;
+    }
+    startingCommands_ = false;
+}
+
+void JobScheduler::start(Job & job)
+{
+    job.state = JobState::running;
+    QProcess * const process = new QProcess(this);
+    process->setProperty(jobIdProperty, job.id);
+    process->setProperty(commandIndexProperty, int(job.startedCount));
+    process->setProcessChannelMode(QProcess::ForwardedChannels);
+    connect(process, SIGNAL(finished(int, QProcess::ExitStatus)),
+            SLOT(onFinished(int, QProcess::ExitStatus)));
+    connect(process, SIGNAL(error(QProcess::ProcessError)),
+            SLOT(onError(QProcess::ProcessError)));
+    const CommandTemplate::Command & command =
+        job.commands[job.startedCount];
+    ++job.startedCount;
+    ++runningCount_;
+    process->start(command.first, command.second);
+}
+
+void JobScheduler::onDone(QProcess * const process, const QString & failure)
+{
+    process->deleteLater();
+    --runningCount_;
+    Job * const job = find(process->property(jobIdProperty).toUInt());
+    if (job != nullptr) {
+        // Failures of killed commands are expected.
+        if (! failure.isEmpty() && job->state != JobState::canceled) {
+            const CommandTemplate::Command & command = job->commands[
+                        std::size_t(process->property(commandIndexProperty).
+                                    toInt())];
+            job->failures << tr("%1 (%2 argument(s)): %3").arg(
+                              command.first).arg(command.second.size()).
+                          arg(failure);
+        }
+        ++job->finishedCount;
+        finish(* job);
+    }
+    startCommands();
+    emit jobsChanged();
+}
+
+void JobScheduler::finish(Job & job)
+{
+    if (job.finishedCount != job.startedCount)
+        return;
+    if (job.state == JobState::running) {
+        if (job.startedCount != job.commands.size())
+            return;
+        job.state = JobState::finished;
+        if (! job.failures.empty()) {
+            QMessageBox * const messageBox = new QMessageBox(
+                QMessageBox::Warning, tr("Custom action failed"),
+                tr("%1 of %2 command(s) of custom action \"%3\" failed.").
+                arg(job.failures.size()).arg(job.commands.size()).
+                arg(job.actionText));
+            messageBox->setDetailedText(job.failures.join("\n"));
+            messageBox->setAttribute(Qt::WA_DeleteOnClose);
+            messageBox->show();
+        }
+    }
+    else if (job.state != JobState::canceled)
+        return;
+    // Commands of a canceled job could have changed files too.
+    if (job.cleanUpPlaylist && job.startedCount != 0)
+        emit playlistCleanUpRequested();
+}
+
+JobScheduler::Job * JobScheduler::find(const JobId id)
+{
+    const auto it = std::find_if(jobs_.begin(), jobs_.end(),
+    [id](const Job & job) {
+        return job.id == id;
+    });
+    return it == jobs_.end() ? nullptr : & * it;
+}
+
+void JobScheduler::onFinished(const int exitCode,
+                              const QProcess::ExitStatus exitStatus)
+{
+    QProcess * const process = qobject_cast<QProcess *>(sender());
+    if (exitStatus == QProcess::CrashExit)
+        onDone(process, tr("crashed."));
+    else if (exitCode != 0)
+        onDone(process, tr("exited with code %1.").arg(exitCode));
+    else
+        onDone(process, QString());
+}
+
+void JobScheduler::onError(const QProcess::ProcessError error)
+{
+    // finished() is emitted after all other errors.
+    if (error == QProcess::FailedToStart) {
+        QProcess * const process = qobject_cast<QProcess *>(sender());
+        onDone(process, tr("failed to start: %1").arg(process->errorString()));
+    }
+}
+
+}
+
@@ -0,0 +1,136 @@
+/*
+ This file is part of Venturous.
+ Copyright (C) 2026 Igor Kushnir <igorkuo AT Google mail>
+
+ Venturous is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Venturous is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ Venturous.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef VENTUROUS_CUSTOM_ACTION_JOBS_HPP
+# define VENTUROUS_CUSTOM_ACTION_JOBS_HPP
+
+# include "CustomActions.hpp"
+
+# include <QString>
+# include <QStringList>
+# include <QObject>
+# include <QProcess>
+
+# include <cstddef>
+# include <deque>
+# include <vector>
+
+
+namespace CustomActions
+{
+/// Runs commands of triggered custom actions. Each triggered action is a job
+/// that consists of one or more commands (batches of items). Jobs are run in
+/// the order they were added; the total number of simultaneously running
+/// commands is limited. Failed commands are reported after their job
+/// finishes.
+/// NOTE: methods do not block execution.
+class JobScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    typedef unsigned JobId;
+
+    enum class JobState : unsigned char
+    {
+        queued, running, finished, canceled
+    };
+
+    struct Job {
+        JobId id;
+        QString actionText;
+        std::vector<CommandTemplate::Command> commands;
+        bool cleanUpPlaylist;
+        JobState state;
+        /// Number of commands that were started.
+        std::size_t startedCount;
+        std::size_t finishedCount;
+        /// Descriptions of failed commands.
+        QStringList failures;
+    };
+
+    typedef std::deque<Job> Jobs;
+
+    static constexpr std::size_t maxFinishedJobCount = 100;
+
+    explicit JobScheduler(QObject * parent = nullptr);
+    /// NOTE: running commands are left running, as detached processes would.
+    ~JobScheduler();
+
+    /// @param maxParallel Maximum number of simultaneously running commands.
+    /// 0 means the number of CPU cores.
+    void setMaxParallel(unsigned maxParallel);
+
+    /// @brief Adds job and starts its commands if the limit allows.
+    /// @param cleanUpPlaylist If true, playlistCleanUpRequested() is emitted
+    /// after the job finishes.
+    void add(QString actionText, std::vector<CommandTemplate::Command> commands,
+             bool cleanUpPlaylist);
+
+    /// @return Jobs in the order they were added. Finished and canceled jobs
+    /// are kept until removeFinished() is called or until there are more
+    /// than maxFinishedJobCount of them, in which case the oldest ones are
+    /// removed by add().
+    const Jobs & jobs() const { return jobs_; }
+
+    /// @brief Discards not started commands of job id and kills its running
+    /// commands.
+    void cancel(JobId id);
+    /// @brief Removes finished and canceled jobs from jobs().
+    void removeFinished();
+
+signals:
+    /// @brief Is emitted after jobs() or state of some job changes.
+    void jobsChanged();
+    /// @brief Is emitted after a job with cleanUpPlaylist option finishes.
+    void playlistCleanUpRequested();
+
+private:
+    /// @brief Removes the oldest finished and canceled jobs so that no more
+    /// than maxFinishedJobCount of them remain.
+    /// NOTE: must not be called while jobs_ is being iterated over, e.g. from
+    /// onDone(), which can be called from startCommands().
+    void removeOldFinished();
+    /// @brief Starts commands of unfinished jobs while the limit allows.
+    void startCommands();
+    /// @brief Starts the next command of job.
+    void start(Job & job);
+    /// @brief Deletes process and updates its job.
+    /// @param failure Description of failure or empty string if the command
+    /// succeeded.
+    void onDone(QProcess * process, const QString & failure);
+    /// @brief Updates job state after its command is finished.
+    void finish(Job & job);
+    /// @return Job with the specified id or nullptr if there is no such job.
+    Job * find(JobId id);
+
+
+    Jobs jobs_;
+    JobId nextId_ = 0;
+    std::size_t maxRunningCount_;
+    std::size_t runningCount_ = 0;
+    /// Is true while startCommands() is running.
+    bool startingCommands_ = false;
+
+private slots:
+    void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onError(QProcess::ProcessError error);
+};
+
+}
+
+# endif // VENTUROUS_CUSTOM_ACTION_JOBS_HPP
@@ -0,0 +1,131 @@
+/*
+ This file is part of Venturous.
+ Copyright (C) 2026 Igor Kushnir <igorkuo AT Google mail>
+
+ Venturous is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Venturous is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ Venturous.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# include "CustomActionJobsWidget.hpp"
+
+# include "CustomActionJobs.hpp"
+
+# include <QString>
+# include <QStringList>
+# include <QVariant>
+# include <QList>
+# include <QTreeWidgetItem>
+# include <QHBoxLayout>
+# include <QVBoxLayout>
+# include <QPushButton>
+
+# include <cstddef>
+
+
+namespace
+{
+QString toString(const CustomActions::JobScheduler::JobState state)
+{
+    typedef CustomActions::JobScheduler::JobState JobState;
+    switch (state) {
+        case JobState::queued:
+            return QObject::tr("Queued");
+        case JobState::running:
+            return QObject::tr("Running");
+        case JobState::finished:
+            return QObject::tr("Finished");
+        case JobState::canceled:
+            return QObject::tr("Canceled");
+    }
+    return QString();
+}
+
+}
+
+
+namespace CustomActions
+{
+JobsWidget::JobsWidget(JobScheduler & scheduler, QWidget * const parent,
+                       const Qt::WindowFlags f)
+    : QWidget(parent, f), scheduler_(scheduler)
+{
+    tree_.setRootIsDecorated(false);
+    tree_.setSelectionMode(QAbstractItemView::ExtendedSelection);
+    tree_.setHeaderLabels( { tr("Action"), tr("State"), tr("Commands"),
+                             tr("Failed")
+                           });
+
+    QVBoxLayout * const layout = new QVBoxLayout(this);
+    layout->addWidget(& tree_);
+    {
+        QHBoxLayout * const buttonsLayout = new QHBoxLayout;
+        QPushButton * const cancelButton =
+            new QPushButton(tr("Cancel selected"), this);
+        cancelButton->setToolTip(
+            tr("Discard queued commands of selected jobs and kill their "
+               "running commands."));
+        connect(cancelButton, SIGNAL(clicked(bool)), SLOT(cancelSelected()));
+        buttonsLayout->addWidget(cancelButton);
+
+        QPushButton * const removeButton =
+            new QPushButton(tr("Remove finished"), this);
+        removeButton->setToolTip(
+            tr("Remove finished and canceled jobs from the list."));
+        connect(removeButton, SIGNAL(clicked(bool)), SLOT(removeFinished()));
+        buttonsLayout->addWidget(removeButton);
+
+        buttonsLayout->addStretch();
+        layout->addLayout(buttonsLayout);
+    }
+
+    connect(& scheduler_, SIGNAL(jobsChanged()), SLOT(updateJobs()));
+    updateJobs();
+}
+
+void JobsWidget::updateJobs()
+{
+    QList<JobScheduler::JobId> selectedIds;
+    for (const QTreeWidgetItem * const item : tree_.selectedItems())
+        selectedIds << item->data(0, Qt::UserRole).toUInt();
+
+    tree_.clear();
+    for (const JobScheduler::Job & job : scheduler_.jobs()) {
+        QTreeWidgetItem * const item = new QTreeWidgetItem(QStringList {
+            job.actionText, toString(job.state),
+            tr("%1 of %2 finished").arg(job.finishedCount).
+            arg(job.commands.size()),
+            QString::number(job.failures.size())
+        });
+        item->setData(0, Qt::UserRole, job.id);
+        if (! job.failures.empty())
+            item->setToolTip(3, job.failures.join("\n"));
+        tree_.addTopLevelItem(item);
+        item->setSelected(selectedIds.contains(job.id));
+    }
+}
+
+void JobsWidget::cancelSelected()
+{
+    QList<JobScheduler::JobId> ids;
+    for (const QTreeWidgetItem * const item : tree_.selectedItems())
+        ids << item->data(0, Qt::UserRole).toUInt();
+    for (const JobScheduler::JobId id : ids)
+        scheduler_.cancel(id);
+}
+
+void JobsWidget::removeFinished()
+{
+    scheduler_.removeFinished();
+}
+
+}
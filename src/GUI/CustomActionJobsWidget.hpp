@@ -0,0 +1,55 @@
+/*
+ This file is part of Venturous.
+ Copyright (C) 2026 Igor Kushnir <igorkuo AT Google mail>
+
+ Venturous is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Venturous is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ Venturous.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef VENTUROUS_CUSTOM_ACTION_JOBS_WIDGET_HPP
+# define VENTUROUS_CUSTOM_ACTION_JOBS_WIDGET_HPP
+
+# include <QtGlobal>
+# include <QWidget>
+# include <QTreeWidget>
+
+
+namespace CustomActions
+{
+class JobScheduler;
+
+/// Shows jobs of JobScheduler with their progress. Allows to cancel selected
+/// jobs and to remove finished jobs from the list.
+class JobsWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    /// NOTE: scheduler must remain valid throughout this JobsWidget's
+    /// lifetime.
+    explicit JobsWidget(JobScheduler & scheduler, QWidget * parent = nullptr,
+                        Qt::WindowFlags f = 0);
+
+private:
+    JobScheduler & scheduler_;
+    QTreeWidget tree_;
+
+private slots:
+    /// @brief Fills tree_ with scheduler_'s jobs.
+    void updateJobs();
+    void cancelSelected();
+    void removeFinished();
+};
+
+}
+
+# endif // VENTUROUS_CUSTOM_ACTION_JOBS_WIDGET_HPP
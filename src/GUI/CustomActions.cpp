@@ -23,24 +23,37 @@
 
 
 # include "CustomActions.hpp"
+# include "CustomActionJobs.hpp"
 
 # include <QtWidgetsUtilities/TooltipShower.hpp>
 
 # include <QPoint>
 # include <QString>
 # include <QStringList>
+# include <QVariant>
 # include <QObject>
 # include <QDir>
+# include <QFile>
 # include <QFileInfo>
-# include <QProcess>
 # include <QAction>
 # include <QMenu>
+# include <QProcess>
 
 # include <cstddef>
+# include <cstring>
+# include <climits>
 # include <utility>
+# include <algorithm>
 # include <array>
-# include <tuple>
+# include <limits>
 # include <memory>
+# include <vector>
+
+# ifndef Q_OS_WIN
+# include <unistd.h>
+
+extern char ** environ;
+# endif
 
 
 namespace
@@ -50,7 +63,9 @@ class CustomMenu : public QObject
     Q_OBJECT
 public:
     explicit CustomMenu(const CustomActions::Actions & actions,
-                        QString commonItemPrefix, QStringList itemNames);
+                        QString commonItemPrefix, QStringList itemNames,
+                        const CustomActions::IsDirectory & isDirectory,
+                        CustomActions::JobScheduler & scheduler);
     ~CustomMenu();
 
     /// @brief Shows popup menu if it is not empty at the specified position.
@@ -63,8 +78,16 @@ private slots:
     void onActionTriggered(QAction * action);
 
 private:
+    struct Entry {
+        CustomActions::CommandTemplate commandTemplate;
+        bool cleanUpPlaylist;
+    };
+
     QString commonItemPrefix_;
     QStringList itemNames_;
+    CustomActions::JobScheduler & scheduler_;
+    /// Displayed actions. Data of each QAction is an index in this vector.
+    std::vector<Entry> entries_;
     std::unique_ptr<QMenu> menu_;
 };
 
@@ -76,8 +99,10 @@ public:
     typedef CustomActions::Action Action;
 
     explicit Validator(const QString & commonItemPrefix,
-                   const QStringList & itemNames) noexcept :
-    commonItemPrefix_(commonItemPrefix), itemNames_(itemNames) {}
+                       const QStringList & itemNames,
+                       const CustomActions::IsDirectory & isDirectory) noexcept
+        : commonItemPrefix_(commonItemPrefix), itemNames_(itemNames),
+          isDirectory_(isDirectory) {}
 
     bool isDisplayable(const Action & action) {
         return action.enabled &&
@@ -92,30 +117,36 @@ private:
     }
 
     bool isDisplayable(Action::Type type);
+    bool isDirectory(int itemIndex) const;
 
 
     const QString & commonItemPrefix_;
     const QStringList & itemNames_;
+    const CustomActions::IsDirectory & isDirectory_;
     std::array<bool, 2> displayedType_;
     bool checkedType_ = false;
 };
 
-std::pair<QString, QStringList> getProgramAndArgs(
-    QString command, const QString & commonItemPrefix, QStringList itemNames);
-
-
 CustomMenu::CustomMenu(const CustomActions::Actions & actions,
-                       QString commonItemPrefix, QStringList itemNames)
+                       QString commonItemPrefix, QStringList itemNames,
+                       const CustomActions::IsDirectory & isDirectory,
+                       CustomActions::JobScheduler & scheduler)
     : commonItemPrefix_(std::move(commonItemPrefix)),
-      itemNames_(std::move(itemNames))
+      itemNames_(std::move(itemNames)), scheduler_(scheduler)
 {
-    Validator validator(commonItemPrefix_, itemNames_);
+    Validator validator(commonItemPrefix_, itemNames_, isDirectory);
     for (const CustomActions::Action & a : actions) {
         if (validator.isDisplayable(a)) {
             if (menu_ == nullptr)
                 menu_.reset(new QMenu(tr("Custom actions")));
             QAction * const action = new QAction(a.text, menu_.get());
             action->setToolTip(a.command);
+            action->setData(int(entries_.size()));
+            entries_.push_back( {
+                a.commandTemplate.command() == a.command ?
+                a.commandTemplate : CustomActions::CommandTemplate(a.command),
+                a.cleanUpPlaylist
+            });
             menu_->addAction(action);
         }
     }
@@ -148,13 +179,29 @@ void CustomMenu::onActionTriggered(QAction * const action)
               QtUtilities::qStringToString(action->text()) + "\"." << std::endl;
 # endif
 
-    QString command;
-    QStringList args;
-    std::tie(command, args) =
-        getProgramAndArgs(action->toolTip(), std::move(commonItemPrefix_),
-                          std::move(itemNames_));
-    if (! command.isEmpty())
-        QProcess::startDetached(command, args);
+    const Entry & entry = entries_[std::size_t(action->data().toInt())];
+    const CustomActions::CommandTemplate & commandTemplate =
+        entry.commandTemplate;
+# ifdef DEBUG_VENTUROUS_CUSTOM_ACTIONS
+    if (! commandTemplate.error().isEmpty()) {
+        std::cout << "Invalid command: "
+                  << QtUtilities::qStringToString(commandTemplate.error())
+                  << std::endl;
+    }
+# endif
+    std::vector<CustomActions::CommandTemplate::Command> commands =
+        commandTemplate.instantiateBatches(commonItemPrefix_, itemNames_);
+    // Interactive programs (file manager, media player) must not hold
+    // scheduler's slots, so a single command is started detached. Exit
+    // statuses are needed only for batches and playlist clean-up.
+    if (commands.size() == 1 && ! entry.cleanUpPlaylist) {
+        const CustomActions::CommandTemplate::Command & command =
+            commands.front();
+        QProcess::startDetached(command.first, command.second);
+        return;
+    }
+    scheduler_.add(action->text(), std::move(commands),
+                   entry.cleanUpPlaylist);
 }
 
 
@@ -168,8 +215,8 @@ bool Validator::isDisplayable(const Action::Type type)
 
     if (! checkedType_) {
         displayedType_.fill(true);
-        for (const QString & name : itemNames_) {
-            if (QFileInfo(commonItemPrefix_ + name).isDir()) {
+        for (int i = 0; i < itemNames_.size(); ++i) {
+            if (isDirectory(i)) {
                 displayedType(Action::Type::file) = false;
                 if (! displayedType(Action::Type::directory))
                     break; // both file and dir were found.
@@ -185,6 +232,13 @@ bool Validator::isDisplayable(const Action::Type type)
     return displayedType(type);
 }
 
+bool Validator::isDirectory(const int itemIndex) const
+{
+    if (isDirectory_)
+        return isDirectory_(itemIndex);
+    return QFileInfo(commonItemPrefix_ + itemNames_[itemIndex]).isDir();
+}
+
 
 constexpr bool needsEscapingWithinDoubleQuotes(char c) noexcept {
     // See https://www.gnu.org/software/bash/manual/html_node/Double-Quotes.html
@@ -234,6 +288,77 @@ QString joinArgs(const QString & commonItemPrefix,
 # endif
 }
 
+# ifdef Q_OS_WIN
+/// CreateProcess() limit on command line length in UTF-16 code units.
+constexpr std::size_t maxCommandLineSize = 32767;
+
+/// @return Upper bound of the space that arg takes in a command line.
+/// NOTE: follows the rules QProcess uses to build the command line: each
+/// double quote is escaped with a backslash and the backslashes preceding it
+/// are doubled.
+std::size_t argumentSize(const QString & arg)
+{
+    // Separator and quotes.
+    std::size_t size = std::size_t(arg.size()) + 3;
+    std::size_t backslashCount = 0;
+    for (const QChar c : arg) {
+        if (c == '\\')
+            ++backslashCount;
+        else {
+            if (c == '"')
+                size += backslashCount + 1;
+            backslashCount = 0;
+        }
+    }
+    return size;
+}
+
+std::size_t maxCommandSize()
+{
+    return maxCommandLineSize;
+}
+
+std::size_t maxArgumentSize()
+{
+    return maxCommandLineSize;
+}
+# else
+/// @return Space that arg takes in the memory passed to execve().
+std::size_t argumentSize(const QString & arg)
+{
+    // Terminating null character and argv pointer.
+    return std::size_t(QFile::encodeName(arg).size()) + 1 + sizeof(char *);
+}
+
+/// @return Maximum total size of program and its arguments.
+std::size_t maxCommandSize()
+{
+    long argMax = sysconf(_SC_ARG_MAX);
+    if (argMax <= 0)
+        argMax = _POSIX_ARG_MAX;
+    // Arguments share this space with environment, which is inherited by
+    // child processes.
+    std::size_t reserved = 0;
+    for (char ** variable = environ; * variable != nullptr; ++variable)
+        reserved += std::strlen(* variable) + 1 + sizeof(char *);
+    // POSIX xargs leaves this much room for the child to modify its
+    // environment.
+    reserved += 2048;
+    return std::size_t(argMax) > reserved ? std::size_t(argMax) - reserved : 0;
+}
+
+/// @return Maximum size of a single argument.
+std::size_t maxArgumentSize()
+{
+# ifdef Q_OS_LINUX
+    // MAX_ARG_STRLEN in Linux kernel.
+    return 32 * std::size_t(sysconf(_SC_PAGESIZE));
+# else
+    return std::numeric_limits<std::size_t>::max();
+# endif
+}
+# endif // Q_OS_WIN
+
 QStringList getArgs(const QString & commonItemPrefix,
                     const QStringList & itemNames)
 {
@@ -252,40 +377,53 @@ QStringList getArgs(const QString & commonItemPrefix,
     return args;
 }
 
-std::pair<QString, QStringList> getProgramAndArgs(
-    QString command, const QString & commonItemPrefix, QStringList itemNames)
+}
+
+namespace CustomActions
 {
-    QStringList args;
+CommandTemplate::CommandTemplate(const QString & command) : command_(command)
+{
+    std::vector<Piece> word;
+    const auto appendText = [&word](const QString & text) {
+        if (word.empty() || word.back().type != PieceType::text)
+            word.push_back( { PieceType::text, QString() });
+        word.back().text += text;
+    };
+    const auto appendPlaceholder = [&word](PieceType type) {
+        word.push_back( { type, QString() });
+    };
 
-    QString current;
     enum class Mode : unsigned char { plain, inSingleQuotes, inDoubleQuotes };
     Mode mode = Mode::plain;
 
     for (int i = 0; i < command.size(); ++i) {
-        const auto pushToCurrent = [&] { current += command[i]; };
+        const auto appendCurrent = [&] { appendText(command[i]); };
         switch (toChar(command[i])) {
             case '\\':
                 if (mode == Mode::plain) {
-                    if (++i == command.size())
-                        return { QString(), QStringList() }; // Wrong syntax.
-                    else
-                        pushToCurrent();
+                    if (++i == command.size()) {
+                        error_ = QObject::tr("Backslash at the end of command.");
+                        words_.clear();
+                        return;
+                    }
+                    appendCurrent();
                 }
                 else if (mode == Mode::inDoubleQuotes) {
-                    if (++i != command.size()) { // Wrong syntax otherwise.
+                    // Backslash at the end means unterminated double quotes.
+                    if (++i != command.size()) {
                         const char c = toChar(command[i]);
                         if (c == '?' || c == '@'
                                 || needsEscapingWithinDoubleQuotes(c)) {
-                            pushToCurrent(); // escaped.
+                            appendCurrent(); // escaped.
                         }
                         else if (c != '\n') { // escaped newline is removed.
                             --i; // appending backslash symbol.
-                            pushToCurrent();
+                            appendCurrent();
                         }
                     }
                 }
                 else
-                    pushToCurrent();
+                    appendCurrent();
                 break;
             case '"':
                 if (mode == Mode::plain)
@@ -293,13 +431,13 @@ std::pair<QString, QStringList> getProgramAndArgs(
                 else if (mode == Mode::inDoubleQuotes)
                     mode = Mode::plain;
                 else
-                    pushToCurrent();
+                    appendCurrent();
                 break;
             case '\'':
                 if (mode == Mode::plain)
                     mode = Mode::inSingleQuotes;
                 else if (mode == Mode::inDoubleQuotes)
-                    pushToCurrent();
+                    appendCurrent();
                 else
                     mode = Mode::plain;
                 break;
@@ -307,40 +445,27 @@ std::pair<QString, QStringList> getProgramAndArgs(
             case '\t':
             case '\n':
                 if (mode == Mode::plain) {
-                    if (! current.isEmpty()) {
-                        args << std::move(current);
-                        current.clear();
+                    if (! word.empty()) {
+                        words_.push_back(std::move(word));
+                        word.clear();
                     }
                 }
                 else
-                    pushToCurrent();
+                    appendCurrent();
                 break;
             case '?':
-                if (mode == Mode::plain) {
-                    QStringList a = getArgs(commonItemPrefix, itemNames);
-                    if (! a.empty()) {
-                        a.front().prepend(std::move(current));
-                        current = std::move(a.back());
-                        a.pop_back();
-                        args << std::move(a);
-                    }
-                }
+                if (mode == Mode::plain)
+                    appendPlaceholder(PieceType::items);
                 else if (mode == Mode::inDoubleQuotes)
-                    current += joinArgs(commonItemPrefix, itemNames);
+                    appendPlaceholder(PieceType::joinedItems);
                 else
-                    pushToCurrent();
+                    appendCurrent();
                 break;
             case '@':
-                if (mode == Mode::plain || mode == Mode::inDoubleQuotes) {
-                    current +=
-# ifdef WIN32_CUSTOM_ACTIONS_USE_BACKSLASH
-                        replaceSlashesWithBackslashes(commonItemPrefix);
-# else
-                        commonItemPrefix;
-# endif
-                }
+                if (mode == Mode::plain || mode == Mode::inDoubleQuotes)
+                    appendPlaceholder(PieceType::commonItemPrefix);
                 else
-                    pushToCurrent();
+                    appendCurrent();
                 break;
             case '~':
                 if (mode == Mode::plain) {
@@ -348,33 +473,134 @@ std::pair<QString, QStringList> getProgramAndArgs(
 # ifdef WIN32_CUSTOM_ACTIONS_USE_BACKSLASH
                     inPlaceReplaceSlashesWithBackslashes(homePath);
 # endif
-                    current += std::move(homePath);
+                    appendText(homePath);
                 }
                 else
-                    pushToCurrent();
+                    appendCurrent();
                 break;
             default:
-                pushToCurrent();
+                appendCurrent();
         }
     }
 
-    if (mode != Mode::plain)
-        return { QString(), QStringList() }; // Wrong syntax.
-    if (! current.isEmpty())
-        args << std::move(current);
-    if (args.empty())
-        command.clear();
-    else {
-        command = std::move(args.front());
-        args.removeFirst();
+    if (mode != Mode::plain) {
+        error_ = mode == Mode::inSingleQuotes ?
+                 QObject::tr("Unterminated single quotes.") :
+                 QObject::tr("Unterminated double quotes.");
+        words_.clear();
+        return;
     }
-    return { std::move(command), std::move(args) };
+    if (! word.empty())
+        words_.push_back(std::move(word));
 }
 
+CommandTemplate::Command CommandTemplate::instantiate(
+    const QString & commonItemPrefix, const QStringList & itemNames) const
+{
+    QStringList args;
+    for (const std::vector<Piece> & word : words_) {
+        QString current;
+        for (const Piece & piece : word) {
+            switch (piece.type) {
+                case PieceType::text:
+                    current += piece.text;
+                    break;
+                case PieceType::items:
+                {
+                    QStringList a = getArgs(commonItemPrefix, itemNames);
+                    if (! a.empty()) {
+                        a.front().prepend(std::move(current));
+                        current = std::move(a.back());
+                        a.pop_back();
+                        args << std::move(a);
+                    }
+                    break;
+                }
+                case PieceType::joinedItems:
+                    current += joinArgs(commonItemPrefix, itemNames);
+                    break;
+                case PieceType::commonItemPrefix:
+                    current +=
+# ifdef WIN32_CUSTOM_ACTIONS_USE_BACKSLASH
+                        replaceSlashesWithBackslashes(commonItemPrefix);
+# else
+                        commonItemPrefix;
+# endif
+                    break;
+            }
+        }
+        if (! current.isEmpty())
+            args << std::move(current);
+    }
+    if (args.empty())
+        return { QString(), QStringList() };
+    QString program = std::move(args.front());
+    args.removeFirst();
+    return { std::move(program), std::move(args) };
 }
 
-namespace CustomActions
+std::vector<CommandTemplate::Command> CommandTemplate::instantiateBatches(
+    const QString & commonItemPrefix, const QStringList & itemNames) const
+{
+    std::vector<Command> result;
+    int placeholderCount = 0;
+    bool joined = false;
+    for (const std::vector<Piece> & word : words_) {
+        for (const Piece & piece : word) {
+            if (piece.type == PieceType::items ||
+                    piece.type == PieceType::joinedItems) {
+                ++placeholderCount;
+                joined = piece.type == PieceType::joinedItems;
+            }
+        }
+    }
+
+    const Command base = instantiate(commonItemPrefix, QStringList());
+    // Items can not be split safely if they are referenced several times or
+    // if the program itself depends on them.
+    if (placeholderCount != 1 || base.first.isEmpty() || itemNames.size() < 2) {
+        Command command = instantiate(commonItemPrefix, itemNames);
+        if (! command.first.isEmpty())
+            result.push_back(std::move(command));
+        return result;
+    }
+
+    std::size_t baseSize = argumentSize(base.first);
+    for (const QString & arg : base.second)
+        baseSize += argumentSize(arg);
+    // Joined items form a single argument.
+    const std::size_t limit =
+        joined ? std::min(maxCommandSize(), maxArgumentSize())
+        : maxCommandSize();
+    const std::size_t available = limit > baseSize ? limit - baseSize : 0;
+
+    QStringList batch;
+    std::size_t batchSize = 0;
+    for (const QString & name : itemNames) {
+        const std::size_t size = argumentSize(commonItemPrefix + name);
+        // An item that does not fit even alone is passed anyway so that
+        // the failure is reported.
+        if (! batch.empty() && batchSize + size > available) {
+            result.push_back(instantiate(commonItemPrefix, batch));
+            batch.clear();
+            batchSize = 0;
+        }
+        batch << name;
+        batchSize += size;
+    }
+    result.push_back(instantiate(commonItemPrefix, batch));
+    return result;
+}
+
+void compileCommands(Actions & actions)
 {
+    for (Action & a : actions) {
+        if (a.commandTemplate.command() != a.command)
+            a.commandTemplate = CommandTemplate(a.command);
+    }
+}
+
+
 constexpr Action::TypeUnderlyingType Action::maxType;
 constexpr int Action::minMinArgN, Action::maxMinArgN,
           Action::minMaxArgN, Action::maxMaxArgN;
@@ -384,24 +610,28 @@ bool operator == (const Action & lhs, const Action & rhs)
     return lhs.enabled == rhs.enabled &&
            lhs.text == rhs.text && lhs.command == rhs.command &&
            lhs.minArgN == rhs.minArgN && lhs.maxArgN == rhs.maxArgN &&
-           lhs.type == rhs.type && lhs.comment == rhs.comment;
+           lhs.type == rhs.type && lhs.comment == rhs.comment &&
+           lhs.cleanUpPlaylist == rhs.cleanUpPlaylist;
 }
 
 bool showMenu(const Actions & actions, QString commonItemPrefix,
-              QStringList itemNames, const QPoint & position)
+              QStringList itemNames, const QPoint & position,
+              JobScheduler & scheduler, const IsDirectory & isDirectory)
 {
     CustomMenu * const menu = new CustomMenu(
-        actions, std::move(commonItemPrefix), std::move(itemNames));
+        actions, std::move(commonItemPrefix), std::move(itemNames),
+        isDirectory, scheduler);
     return menu->popup(position);
 }
 
 void showMenu(const Actions & actions, QString commonItemPrefix,
               QStringList itemNames, const QPoint & position,
-              QtUtilities::Widgets::TooltipShower & tooltipShower)
+              QtUtilities::Widgets::TooltipShower & tooltipShower,
+              JobScheduler & scheduler, const IsDirectory & isDirectory)
 {
     const int nItems = itemNames.size();
     if (! showMenu(actions, std::move(commonItemPrefix), std::move(itemNames),
-                   position)) {
+                   position, scheduler, isDirectory)) {
         tooltipShower.show(
             position,
             QObject::tr("No custom actions are enabled for selected %1.").
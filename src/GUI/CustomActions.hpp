@@ -21,7 +21,10 @@
 
 # include <QtGlobal>
 # include <QString>
+# include <QStringList>
 
+# include <utility>
+# include <functional>
 # include <vector>
 
 
@@ -33,10 +36,75 @@ class TooltipShower;
 }
 }
 QT_FORWARD_DECLARE_CLASS(QPoint)
-QT_FORWARD_DECLARE_CLASS(QStringList)
 
 namespace CustomActions
 {
+class JobScheduler;
+
+/// Action::command split into arguments, which consist of literal text and
+/// placeholders for items. Quoting and escaping rules are applied once, when
+/// the template is compiled, so that substituting items requires no parsing.
+class CommandTemplate
+{
+public:
+    /// Program and its arguments.
+    typedef std::pair<QString, QStringList> Command;
+
+    CommandTemplate() = default;
+    /// @brief Compiles command. See Action::command for syntax.
+    explicit CommandTemplate(const QString & command);
+
+    /// @return Command this template was compiled from.
+    const QString & command() const { return command_; }
+    /// @return Description of syntax error in command() or empty string if
+    /// command() is valid.
+    const QString & error() const { return error_; }
+
+    /// @return Program and its arguments with items substituted for
+    /// placeholders. Program is empty if command() is empty or invalid.
+    /// @param commonItemPrefix The beginning of absolute path that is common
+    /// for all items.
+    /// @param itemNames Individual item's names with commonItemPrefix
+    /// omitted.
+    Command instantiate(const QString & commonItemPrefix,
+                        const QStringList & itemNames) const;
+
+    /// @brief Splits itemNames into contiguous batches and instantiates
+    /// command for each batch, like xargs does. Batches are as large as
+    /// system limits on command line length allow.
+    /// If command() does not contain exactly one placeholder for items, the
+    /// command is instantiated for all items at once.
+    /// @return Commands that together process all items. Empty if
+    /// command() is empty or invalid.
+    std::vector<Command> instantiateBatches(
+        const QString & commonItemPrefix, const QStringList & itemNames) const;
+
+private:
+    enum class PieceType : unsigned char
+    {
+        /// Literal text.
+        text,
+        /// '?' outside of quotes: each item becomes a separate argument.
+        items,
+        /// '?' within double quotes: items are joined with spaces.
+        joinedItems,
+        /// '@'.
+        commonItemPrefix
+    };
+
+    struct Piece {
+        PieceType type;
+        QString text;
+    };
+    /// Arguments that consist of pieces.
+    typedef std::vector<std::vector<Piece>> Words;
+
+
+    QString command_;
+    QString error_;
+    Words words_;
+};
+
 /// @brief Atcion is displayed if (enabled && number_of_args >= minArgN &&
 /// (maxArgN == -1 || number_of_args <= maxArgN) &&
 /// (type == anyItem || all_arg's_types match type)).
@@ -52,7 +120,8 @@ struct Action {
 
     static Action getEmpty() {
         return {
-            QString(), QString(), 1, 1, Action::Type::anyItem, false, QString()
+            QString(), QString(), 1, 1, Action::Type::anyItem, false, QString(),
+            false, CommandTemplate()
         };
     }
 
@@ -70,6 +139,12 @@ struct Action {
     /// Is not used by CustomActions.
     /// Can be used for detailed action description.
     QString comment;
+    /// If true, playlist is cleaned up after the command finishes.
+    /// Should be set for actions that move or remove items.
+    bool cleanUpPlaylist;
+    /// Compiled command. Is set by compileCommands(). Is recompiled before
+    /// use if it does not match command.
+    CommandTemplate commandTemplate;
 };
 
 bool operator == (const Action & lhs, const Action & rhs);
@@ -81,23 +156,42 @@ inline bool operator != (const Action & lhs, const Action & rhs)
 
 typedef std::vector<Action> Actions;
 
+/// @brief Compiles command of each action unless it is already compiled.
+/// Should be called after actions are loaded or changed.
+void compileCommands(Actions & actions);
+
+/// Function that returns true if the item at the specified index in itemNames
+/// is a directory, false if it is a file.
+typedef std::function<bool(int itemIndex)> IsDirectory;
+
 /// @brief Selects displayable elements of actions and shows popup menu with
 /// them at the specified position.
-/// Executes appropriate command if user selects some action.
+/// Runs appropriate command if user selects some action. Command is split
+/// into batches if the items do not fit in a single command line. Batches
+/// and commands of actions with cleanUpPlaylist are added to scheduler;
+/// other commands are started detached.
 /// @param commonItemPrefix The beginning of absolute path that is common for
 /// all items.
 /// @param itemNames Collection of individual item's names with
 /// commonItemPrefix omitted.
+/// @param scheduler Runs commands of triggered actions. Must remain valid
+/// until the menu is hidden.
+/// @param isDirectory Is used to determine item types if some action depends
+/// on them. If empty, item types are queried from file system.
 /// @return true if popup menu was shown, false if there were no displayable
 /// actions.
 bool showMenu(const Actions & actions, QString commonItemPrefix,
-              QStringList itemNames, const QPoint & position);
-/// @brief Calls showMenu(actions, commonItemPrefix, itemNames, position).
-/// If it returns false, uses tooltipShower to show appropriate tooltip at
-/// the same position.
+              QStringList itemNames, const QPoint & position,
+              JobScheduler & scheduler,
+              const IsDirectory & isDirectory = IsDirectory());
+/// @brief Calls showMenu(actions, commonItemPrefix, itemNames, position,
+/// scheduler, isDirectory). If it returns false, uses tooltipShower to show
+/// appropriate tooltip at the same position.
 void showMenu(const Actions & actions, QString commonItemPrefix,
               QStringList itemNames, const QPoint & position,
-              QtUtilities::Widgets::TooltipShower & tooltipShower);
+              QtUtilities::Widgets::TooltipShower & tooltipShower,
+              JobScheduler & scheduler,
+              const IsDirectory & isDirectory = IsDirectory());
 
 }
 
@@ -17,92 +17,37 @@
 */
 
 # ifdef DEBUG_VENTUROUS_ICONS
-# include <QtCoreUtilities/String.hpp>
-# include <algorithm>
 # include <iostream>
 # endif // DEBUG_VENTUROUS_ICONS
 
 
-# ifdef EMBEDDED_ICONS
-# include <QFileInfo>
-# endif // EMBEDDED_ICONS
-
 # include "Icons.hpp"
 
-# include <QtCoreUtilities/String.hpp>
-
 # include <QSize>
 # include <QList>
 # include <QString>
-# include <QStringList>
 # include <QFile>
+# include <QFileInfo>
 # include <QTextStream>
 # include <QIcon>
 
 # include <cstddef>
 # include <utility>
+# include <algorithm>
 # include <array>
-# include <tuple>
 
 
 namespace
 {
-constexpr std::size_t playbackStartIndex = 3, playlistStartIndex = 15,
-                      helpStartIndex = 27, addingPolicyStartIndex = 29;
+const QString themeName = "SimpleFugue";
+/// Values of icon sources in cache file.
+const QString themeSource = "theme", fallbackSource = "fallback";
 
 inline bool isEmpty(const QIcon & icon)
 {
     return icon.availableSizes().empty();
 }
 
-struct IconName {
-    QString context, name;
-
-    IconName() = default;
-
-    explicit IconName(const QString & line) {
-        const QStringList parts = line.split('/', QString::KeepEmptyParts);
-        if (parts.size() != 2)
-            throw Icons::Theme::Error("invalid line format in icon list.");
-        context = std::move(parts.front());
-        name = std::move(parts.back());
-    }
-};
-template <std::size_t nIcons>
-using IconNames = std::array<IconName, nIcons>;
-
-template <std::size_t nIcons>
-IconNames<nIcons> getNames()
-{
-    IconNames<nIcons> names;
-    std::size_t index = 0;
-    const QString filename = Icons::getAbsolutePath("icon_list");
-    QFile source(filename);
-    if (! source.open(QFile::ReadOnly)) {
-        throw Icons::Theme::Error(
-            "could not open " + QtUtilities::qStringToString(filename) +
-            " for reading.");
-    }
-
-    QTextStream stream(& source);
-    QString line;
-    do {
-        line = stream.readLine().trimmed();
-        if (! line.isEmpty()) {
-            if (index == names.size())
-                throw Icons::Theme::Error("too many icons.");
-            names[index] = IconName(line);
-            ++index;
-        }
-    }
-    while (! line.isNull());
-
-    if (index != names.size())
-        throw Icons::Theme::Error("not enough icons.");
-    return names;
-}
-
-# ifdef EMBEDDED_ICONS
 # ifdef DEBUG_VENTUROUS_ICONS
 void printInfo(const QIcon & icon)
 {
@@ -128,6 +73,26 @@ void printInfo(const QIcon & icon)
     }
 }
 # endif // DEBUG_VENTUROUS_ICONS
+
+# ifdef EMBEDDED_ICONS
+/// @brief Adds files of the embedded fallback icon to icon.
+void addFallbackFiles(const Icons::IconName & name, QIcon & icon)
+{
+    const std::array<int, 7> sizes {{ 16, 22, 24, 32, 48, 96, 256 }};
+    const QString prefix = QString(":/icons/%1/").arg(themeName);
+    const QString contextAndName = QString("/%1/%2").arg(
+                                       QLatin1String(name.context),
+                                       QLatin1String(name.name));
+    for (int size : sizes) {
+        const QString filename = prefix + QString("%1x%1").arg(size) +
+                                 contextAndName + ".png";
+        if (QFileInfo(filename).isFile())
+            icon.addFile(filename, QSize(size, size));
+    }
+    const QString scalableIcon = prefix + "scalable" + contextAndName + ".svg";
+    if (QFileInfo(scalableIcon).isFile())
+        icon.addFile(scalableIcon);
+}
 # endif // EMBEDDED_ICONS
 
 } // END unnamed namespace
@@ -135,228 +100,314 @@ void printInfo(const QIcon & icon)
 
 namespace Icons
 {
-Theme::Error::~Error() noexcept = default;
+Theme::Theme(const bool alwaysUseFallbackIcons, QString cacheFilename)
+    : cacheFilename_(std::move(cacheFilename))
+{
+    if (alwaysUseFallbackIcons)
+        QIcon::setThemeName(themeName);
+    sources_.fill(Source::unknown);
+    if (! cacheFilename_.isEmpty()) {
+        cacheKey_ = currentThemeKey();
+        loadCache();
+    }
+}
+
+const QIcon & Theme::icon(const IconId id) const
+{
+    const std::size_t index = std::size_t(id);
+    if (! resolved_[index]) {
+        resolve(index);
+        resolved_[index] = true;
+    }
+    return icons_[index];
+}
+
+bool Theme::saveCache() const
+{
+    if (cacheFilename_.isEmpty() || ! sourcesChanged_)
+        return true;
+    QFile file(cacheFilename_);
+    if (! file.open(QIODevice::WriteOnly | QIODevice::Truncate |
+                    QIODevice::Text)) {
+        return false;
+    }
+    QTextStream stream(& file);
+    stream << cacheKey_ << '\n';
+    for (std::size_t i = 0; i < iconCount; ++i) {
+        if (sources_[i] != Source::unknown) {
+            stream << iconNames[i].context << '/' << iconNames[i].name << ' '
+                   << (sources_[i] == Source::theme ? themeSource :
+                       fallbackSource) << '\n';
+        }
+    }
+    stream.flush();
+    if (stream.status() != QTextStream::Ok)
+        return false;
+    sourcesChanged_ = false;
+    return true;
+}
 
 
-Theme::Theme(const bool alwaysUseFallbackIcons)
+QString Theme::currentThemeKey()
 {
-    constexpr std::size_t nIcons = std::tuple_size<decltype(icons_)>::value;
-    const IconNames<nIcons> names = getNames<nIcons>();
+    const QString name = QIcon::themeName();
+    uint lastModified = 0;
+    for (const QString & path : QIcon::themeSearchPaths()) {
+        const QFileInfo index(path + '/' + name + "/index.theme");
+        if (index.isFile() && index.lastModified().isValid()) {
+            lastModified = std::max(lastModified,
+                                    index.lastModified().toTime_t());
+        }
+    }
+    return name + ' ' + QString::number(lastModified);
+}
+
+void Theme::loadCache()
+{
+    QFile file(cacheFilename_);
+    if (! file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return;
+    QTextStream stream(& file);
+    // Sources that were found in a different or modified theme are useless.
+    if (stream.readLine() != cacheKey_)
+        return;
+
+    for (QString line = stream.readLine(); ! line.isNull();
+            line = stream.readLine()) {
+        const int separator = line.lastIndexOf(' ');
+        if (separator < 0)
+            continue;
+        const QString contextAndName = line.left(separator);
+        const QString source = line.mid(separator + 1);
+        for (std::size_t i = 0; i < iconCount; ++i) {
+            if (contextAndName == QString("%1/%2").arg(
+                        QLatin1String(iconNames[i].context),
+                        QLatin1String(iconNames[i].name))) {
+                if (source == themeSource)
+                    sources_[i] = Source::theme;
+                else if (source == fallbackSource)
+                    sources_[i] = Source::fallback;
+                break;
+            }
+        }
+    }
+}
 
-    const QString themeName = "SimpleFugue";
-    if (alwaysUseFallbackIcons)
-        QIcon::setThemeName(themeName);
-    for (std::size_t i = 0; i < icons_.size(); ++i)
-        icons_[i] = QIcon::fromTheme(names[i].name);
 
+void Theme::resolve(const std::size_t index) const
+{
+    const IconName & name = iconNames[index];
+    QIcon & icon = icons_[index];
 # ifdef EMBEDDED_ICONS
-    const std::array<int, 7> sizes {{ 16, 22, 24, 32, 48, 96, 256 }};
-    const QString prefix = QString(":/icons/%1/").arg(themeName);
-    for (std::size_t i = 0; i < icons_.size(); ++i) {
-# ifdef DEBUG_VENTUROUS_ICONS
-        std::cout << QtUtilities::qStringToString(names[i].name) << " - ";
+    const bool hasFallback = true;
+# else
+    const bool hasFallback = IconId(index) == IconId::venturous;
 # endif
-        if (isEmpty(icons_[i])) {
-            const QString contextAndName =
-                '/' + names[i].context + '/' + names[i].name;
-            for (int size : sizes) {
-                const QString filename = prefix + QString("%1x%1").arg(size) +
-                                         contextAndName + ".png";
-                if (QFileInfo(filename).isFile())
-                    icons_[i].addFile(filename, QSize(size, size));
-            }
-            const QString scalableIcon = prefix + "scalable" +
-                                         contextAndName + ".svg";
-            if (QFileInfo(scalableIcon).isFile())
-                icons_[i].addFile(scalableIcon);
+    if (! hasFallback) {
+        icon = QIcon::fromTheme(QLatin1String(name.name));
+        return;
+    }
 
 # ifdef DEBUG_VENTUROUS_ICONS
-            std::cout << "using fallback icons; ";
+    std::cout << name.name << " - ";
 # endif
-        }
+    Source & source = sources_[index];
+    if (source != Source::fallback)
+        icon = QIcon::fromTheme(QLatin1String(name.name));
+    if (source == Source::unknown) {
+        // This check scans icon theme directories, so its result is cached.
+        source = isEmpty(icon) ? Source::fallback : Source::theme;
+        sourcesChanged_ = true;
+    }
+
+    if (source == Source::fallback) {
+# ifdef EMBEDDED_ICONS
+        addFallbackFiles(name, icon);
 # ifdef DEBUG_VENTUROUS_ICONS
-        printInfo(icons_[i]);
+        std::cout << "using fallback icons; ";
 # endif
-    }
 # endif // EMBEDDED_ICONS
-
-    if (isEmpty(icons_.front())) {
+        if (IconId(index) == IconId::venturous && isEmpty(icon)) {
 # ifdef DEBUG_VENTUROUS_ICONS
-        std::cout << "Using application icon from " APPLICATION_NAME
-                  " resources." << std::endl;
+            std::cout << "using application icon from " APPLICATION_NAME
+                      " resources; ";
 # endif
-        icons_.front().addFile(getAbsolutePath(ICON_NAME ".png"));
+            icon.addFile(getAbsolutePath(ICON_NAME ".png"));
+        }
     }
+# ifdef DEBUG_VENTUROUS_ICONS
+    printInfo(icon);
+# endif
 }
 
 
 const QIcon & Theme::venturous() const
 {
-    return icons_[0];
+    return icon(IconId::venturous);
 }
 
 const QIcon & Theme::preferences() const
 {
-    return icons_[1];
+    return icon(IconId::preferences_desktop);
 }
 
 const QIcon & Theme::quit() const
 {
-    return icons_[2];
+    return icon(IconId::application_exit);
 }
 
 
 const QIcon & Theme::playbackPlay() const
 {
-    return icons_[playbackStartIndex];
+    return icon(IconId::media_playback_start);
 }
 
 const QIcon & Theme::playbackPause() const
 {
-    return icons_[playbackStartIndex + 1];
+    return icon(IconId::media_playback_pause);
 }
 
 const QIcon & Theme::playbackStop() const
 {
-    return icons_[playbackStartIndex + 2];
+    return icon(IconId::media_playback_stop);
 }
 
 const QIcon & Theme::playbackPrevious() const
 {
-    return icons_[playbackStartIndex + 3];
+    return icon(IconId::media_skip_backward);
 }
 
 const QIcon & Theme::playbackReplayLast() const
 {
-    return icons_[playbackStartIndex + 4];
+    return icon(IconId::media_replay_last);
 }
 
 const QIcon & Theme::playbackNextFromHistory() const
 {
-    return icons_[playbackStartIndex + 5];
+    return icon(IconId::media_history_next);
 }
 
 const QIcon & Theme::playbackNextRandom() const
 {
-    return icons_[playbackStartIndex + 6];
+    return icon(IconId::media_next_random);
 }
 
 const QIcon & Theme::playbackNext() const
 {
-    return icons_[playbackStartIndex + 7];
+    return icon(IconId::media_skip_forward);
 }
 
 const QIcon & Theme::playbackPlayAll() const
 {
-    return icons_[playbackStartIndex + 8];
+    return icon(IconId::media_play_all);
 }
 
 const QIcon & Theme::audioPlayerShow() const
 {
-    return icons_[playbackStartIndex + 9];
+    return icon(IconId::audio_player_show);
 }
 
 const QIcon & Theme::audioPlayerHide() const
 {
-    return icons_[playbackStartIndex + 10];
+    return icon(IconId::audio_player_hide);
 }
 
 const QIcon & Theme::viewRefresh() const
 {
-    return icons_[playbackStartIndex + 11];
+    return icon(IconId::view_refresh);
 }
 
 
 const QIcon & Theme::edit() const
 {
-    return icons_[playlistStartIndex];
+    return icon(IconId::list_edit);
 }
 
 const QIcon & Theme::apply() const
 {
-    return icons_[playlistStartIndex + 1];
+    return icon(IconId::dialog_ok_apply);
 }
 
 const QIcon & Theme::cancel() const
 {
-    return icons_[playlistStartIndex + 2];
+    return icon(IconId::dialog_cancel);
 }
 
 const QIcon & Theme::add() const
 {
-    return icons_[playlistStartIndex + 3];
+    return icon(IconId::list_add);
 }
 
 const QIcon & Theme::remove() const
 {
-    return icons_[playlistStartIndex + 4];
+    return icon(IconId::list_remove);
 }
 
 const QIcon & Theme::addDir() const
 {
-    return icons_[playlistStartIndex + 5];
+    return icon(IconId::folder_add);
 }
 
 const QIcon & Theme::cleanUp() const
 {
-    return icons_[playlistStartIndex + 6];
+    return icon(IconId::clean_up);
 }
 
 const QIcon & Theme::clear() const
 {
-    return icons_[playlistStartIndex + 7];
+    return icon(IconId::edit_clear);
 }
 
 const QIcon & Theme::undo() const
 {
-    return icons_[playlistStartIndex + 8];
+    return icon(IconId::edit_undo);
 }
 
 const QIcon & Theme::revert() const
 {
-    return icons_[playlistStartIndex + 9];
+    return icon(IconId::document_revert);
 }
 
 const QIcon & Theme::load() const
 {
-    return icons_[playlistStartIndex + 10];
+    return icon(IconId::document_open);
 }
 
 const QIcon & Theme::saveAs() const
 {
-    return icons_[playlistStartIndex + 11];
+    return icon(IconId::document_save_as);
 }
 
 
 const QIcon & Theme::help() const
 {
-    return icons_[helpStartIndex];
+    return icon(IconId::help_contents);
 }
 
 const QIcon & Theme::about() const
 {
-    return icons_[helpStartIndex + 1];
+    return icon(IconId::help_about);
 }
 
 
 const QIcon & Theme::audioFile() const
 {
-    return icons_[addingPolicyStartIndex];
+    return icon(IconId::audio_file);
 }
 
 const QIcon & Theme::mediaDir() const
 {
-    return icons_[addingPolicyStartIndex + 1];
+    return icon(IconId::media_dir);
 }
 
 const QIcon & Theme::bothAudioFile() const
 {
-    return icons_[addingPolicyStartIndex + 2];
+    return icon(IconId::both_audio_file);
 }
 
 const QIcon & Theme::bothMediaDir() const
 {
-    return icons_[addingPolicyStartIndex + 3];
+    return icon(IconId::both_media_dir);
 }
 
 } // END namespace Icons
@@ -19,14 +19,14 @@
 # ifndef VENTUROUS_ICONS_HPP
 # define VENTUROUS_ICONS_HPP
 
-# include <CommonUtilities/CopyAndMoveSemantics.hpp>
+# include "IconNames.hpp"
 
 # include <QString>
 # include <QIcon>
 
+# include <cstddef>
 # include <array>
-# include <string>
-# include <stdexcept>
+# include <bitset>
 
 
 namespace Icons
@@ -38,20 +38,19 @@ inline QString getAbsolutePath(const QString & filename)
 }
 
 
+/// Icons are resolved on first access, so constructing Theme is cheap.
+/// Whether each icon is found in the current icon theme or must be taken from
+/// fallback icons is remembered in cache file, which spares icon theme
+/// directory scans on later launches with the same icon theme.
 class Theme
 {
 public:
-    class Error : public std::runtime_error
-    {
-    public:
-        explicit Error(const std::string & sWhat) : std::runtime_error(sWhat) {}
-        COPYABLE_AND_MOVABLE(Error)
-        ~Error() noexcept override;
-    };
-
     /// @param alwaysUseFallbackIcons If false, system icon theme will be
     /// preferred. If true, icons from system theme will never be used.
-    explicit Theme(bool alwaysUseFallbackIcons = false);
+    /// @param cacheFilename Name of the file that stores icon sources.
+    /// If empty, icon sources are not cached.
+    explicit Theme(bool alwaysUseFallbackIcons = false,
+                   QString cacheFilename = QString());
 
     const QIcon & venturous() const;
 
@@ -92,8 +91,32 @@ public:
     const QIcon & bothAudioFile() const;
     const QIcon & bothMediaDir() const;
 
+    /// @return Icon with specified id, which is resolved on first call.
+    const QIcon & icon(IconId id) const;
+
+    /// @brief Writes icon sources to cache file if they have changed since
+    /// loading.
+    /// @return true if cache file is up to date.
+    bool saveCache() const;
+
 private:
-    std::array<QIcon, 33> icons_;
+    enum class Source : unsigned char { unknown, theme, fallback };
+
+    /// @return String that identifies current icon theme and its version.
+    static QString currentThemeKey();
+
+    /// @brief Reads icon sources from cache file if it matches cacheKey_.
+    void loadCache();
+    /// @brief Loads icon with specified index into icons_.
+    void resolve(std::size_t index) const;
+
+
+    const QString cacheFilename_;
+    QString cacheKey_;
+    mutable std::array<QIcon, iconCount> icons_;
+    mutable std::bitset<iconCount> resolved_;
+    mutable std::array<Source, iconCount> sources_;
+    mutable bool sourcesChanged_ = false;
 };
 
 }
@@ -30,6 +30,15 @@ namespace CommonTypes
 typedef std::vector<std::string> ItemCollection;
 /// Function that starts playing ItemCollection parameter.
 typedef std::function<void(ItemCollection)> PlayItems;
+
+/// Function that receives items one at a time.
+typedef std::function<void(const std::string &)> ItemConsumer;
+/// Function that passes each item of some sequence to its ItemConsumer
+/// parameter.
+typedef std::function<void(const ItemConsumer &)> ItemProducer;
+/// Function that starts playing items passed by ItemProducer parameter
+/// without storing all of them in memory at once.
+typedef std::function<void(const ItemProducer &)> PlayStreamedItems;
 }
 
 # endif // VENTUROUS_COMMON_TYPES_HPP
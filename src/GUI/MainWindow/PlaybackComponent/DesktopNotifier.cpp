@@ -0,0 +1,124 @@
+/*
+ This file is part of Venturous.
+ Copyright (C) 2026 Igor Kushnir <igorkuo AT Google mail>
+
+ Venturous is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Venturous is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ Venturous.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# include "DesktopNotifier.hpp"
+
+# include <QString>
+# include <QStringList>
+# include <QProcess>
+
+# ifdef DBUS_NOTIFICATIONS
+# include <QVariantMap>
+# include <QDBusConnection>
+# include <QDBusMessage>
+# include <QDBusPendingCall>
+# include <QDBusPendingReply>
+# include <QDBusPendingCallWatcher>
+# endif
+
+
+namespace
+{
+/// Notification summary. Item text is shown in notification body.
+inline QString summaryText() { return "|>"; }
+
+/// @return text with special markup characters replaced.
+QString escapeMarkup(QString text)
+{
+    text.replace('&', "&amp;");
+    text.replace('<', "&lt;");
+    return text;
+}
+
+}
+
+
+void DesktopNotifier::notify(const QString & text)
+{
+# ifdef DBUS_NOTIFICATIONS
+    if (! useNotifySend_) {
+        if (sending_)
+            pendingText_ = text;
+        else
+            send(text);
+        return;
+    }
+# endif
+    runNotifySend(text);
+}
+
+void DesktopNotifier::send(const QString & text)
+{
+# ifdef DBUS_NOTIFICATIONS
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    if (! bus.isConnected()) {
+        useNotifySend_ = true;
+        runNotifySend(text);
+        return;
+    }
+    QDBusMessage message = QDBusMessage::createMethodCall(
+                               "org.freedesktop.Notifications",
+                               "/org/freedesktop/Notifications",
+                               "org.freedesktop.Notifications", "Notify");
+    message << QString(APPLICATION_NAME) << replacesId_
+            << QString(ICON_NAME) << summaryText() << escapeMarkup(text)
+            << QStringList() << QVariantMap() << -1;
+
+    QDBusPendingCallWatcher * const watcher =
+        new QDBusPendingCallWatcher(bus.asyncCall(message), this);
+    connect(watcher, SIGNAL(finished(QDBusPendingCallWatcher *)),
+            SLOT(onSendFinished(QDBusPendingCallWatcher *)));
+    sending_ = true;
+    sentText_ = text;
+# else
+    runNotifySend(text);
+# endif
+}
+
+void DesktopNotifier::runNotifySend(const QString & text)
+{
+    QString body = escapeMarkup(text);
+    // replace special notify-send character.
+    body.replace('\\', "&#92;");
+    QProcess::startDetached("notify-send",
+    { "-a", APPLICATION_NAME, "-i", ICON_NAME, summaryText(), body });
+}
+
+
+void DesktopNotifier::onSendFinished(QDBusPendingCallWatcher * const watcher)
+{
+# ifdef DBUS_NOTIFICATIONS
+    watcher->deleteLater();
+    sending_ = false;
+    QString text;
+    text.swap(pendingText_);
+
+    const QDBusPendingReply<uint> reply = * watcher;
+    if (reply.isError()) {
+        // Notification service is not available - fall back to notify-send.
+        useNotifySend_ = true;
+        runNotifySend(text.isEmpty() ? sentText_ : text);
+        return;
+    }
+    replacesId_ = reply.value();
+    if (! text.isEmpty())
+        send(text);
+# else
+    static_cast<void>(watcher);
+# endif
+}
@@ -0,0 +1,67 @@
+/*
+ This file is part of Venturous.
+ Copyright (C) 2026 Igor Kushnir <igorkuo AT Google mail>
+
+ Venturous is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Venturous is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ Venturous.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef VENTUROUS_DESKTOP_NOTIFIER_HPP
+# define VENTUROUS_DESKTOP_NOTIFIER_HPP
+
+# include <QtGlobal>
+# include <QString>
+# include <QObject>
+
+
+QT_FORWARD_DECLARE_CLASS(QDBusPendingCallWatcher)
+
+/// Shows desktop notifications about played items.
+/// If DBUS_NOTIFICATIONS is defined, notifications are sent asynchronously
+/// over the session bus connection, which is opened once and reused.
+/// Each notification replaces the previous one. Notifications issued while
+/// the previous one is still being sent are coalesced: only the last of them
+/// is shown.
+/// If D-Bus notification service is unavailable or DBUS_NOTIFICATIONS is not
+/// defined, notify-send is run for each notification.
+/// NOTE: methods do not block execution.
+class DesktopNotifier : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DesktopNotifier(QObject * parent = nullptr) : QObject(parent) {}
+
+    /// @brief Shows notification with specified text.
+    void notify(const QString & text);
+
+private:
+    /// @brief Sends notification with specified body over D-Bus.
+    void send(const QString & body);
+    /// @brief Runs notify-send to show notification with specified text.
+    static void runNotifySend(const QString & text);
+
+
+    bool useNotifySend_ = false;
+    bool sending_ = false;
+    /// Identifier of the last shown notification or 0.
+    unsigned replacesId_ = 0;
+    /// Text of the notification that is being sent.
+    QString sentText_;
+    /// Text of the last notification issued while sending or empty string.
+    QString pendingText_;
+
+private slots:
+    void onSendFinished(QDBusPendingCallWatcher * watcher);
+};
+
+# endif // VENTUROUS_DESKTOP_NOTIFIER_HPP
@@ -91,11 +91,13 @@ inline void setShortenedTooltipToText(QListWidgetItem * item, int nHiddenDirs)
 
 
 HistoryWidget::HistoryWidget(const CustomActions::Actions & customActions,
+                             CustomActions::JobScheduler & customActionJobs,
                              PlayExistingEntry playExistingEntry,
                              CommonTypes::PlayItems playItems,
                              const Preferences::Playback::History & preferences,
                              QWidget * const parent)
     : QListWidget(parent), customActions_(customActions),
+      customActionJobs_(customActionJobs),
       playExistingEntry_(std::move(playExistingEntry)),
       playItems_(std::move(playItems)),
       copyPlayedEntryToTop_(preferences.copyPlayedEntryToTop),
@@ -114,8 +116,11 @@ void HistoryWidget::setPreferences(
     if (history_.maxSize() != preferences.maxSize) {
         history_.setMaxSize(preferences.maxSize);
         const int maxSize = static_cast<int>(preferences.maxSize);
-        for (int i = count() - 1; i >= maxSize; --i)
-            delete takeItem(i);
+        if (count() > maxSize) {
+            for (int i = count() - 1; i >= maxSize; --i)
+                delete takeItem(i);
+            emit historyChanged();
+        }
     }
     copyPlayedEntryToTop_ = preferences.copyPlayedEntryToTop;
     if (nHiddenDirs_ != preferences.nHiddenDirs) {
@@ -172,23 +177,24 @@ void HistoryWidget::push(std::string entry)
 {
     if (history_.maxSize() == 0)
         return;
-    history_.push(std::move(entry));
     emphasizeCurrentEntry(false);
-    {
-        QListWidgetItem * const item = new QListWidgetItem;
-        item->setToolTip(QtUtilities::toQString(history_.items().front()));
-        setShortenedTooltipToText(item, nHiddenDirs_);
-        insertItem(0, item);
-    }
-    {
-        const int nItems = count();
-        if (std::size_t(nItems) > history_.maxSize())
-            delete takeItem(nItems - 1);
+    addEntry(std::move(entry));
+    finishPushing();
+}
+
+void HistoryWidget::push(const CommonTypes::ItemCollection & entries)
+{
+    if (history_.maxSize() == 0 || entries.empty())
+        return;
+    emphasizeCurrentEntry(false);
+    // Entries that would be pushed out by the following ones are skipped.
+    const std::size_t skipped = entries.size() > history_.maxSize() ?
+                                entries.size() - history_.maxSize() : 0;
+    for (auto it = entries.cbegin() + std::ptrdiff_t(skipped);
+            it != entries.cend(); ++it) {
+        addEntry(* it);
     }
-    scrollToTop();
-    assert(history_.items().size() == std::size_t(count()));
-    currentEntryIndex_ = 0;
-    emphasizeCurrentEntry();
+    finishPushing();
 }
 
 void HistoryWidget::playedMultipleItems()
@@ -240,6 +246,27 @@ std::string HistoryWidget::setCurrentEntry(const int index)
     return entry;
 }
 
+void HistoryWidget::addEntry(std::string entry)
+{
+    history_.push(std::move(entry));
+    QListWidgetItem * const item = new QListWidgetItem;
+    item->setToolTip(QtUtilities::toQString(history_.items().front()));
+    setShortenedTooltipToText(item, nHiddenDirs_);
+    insertItem(0, item);
+}
+
+void HistoryWidget::finishPushing()
+{
+    for (int nItems = count(); std::size_t(nItems) > history_.maxSize();
+            --nItems) {
+        delete takeItem(nItems - 1);
+    }
+    scrollToTop();
+    assert(history_.items().size() == std::size_t(count()));
+    currentEntryIndex_ = 0;
+    emphasizeCurrentEntry();
+}
+
 void HistoryWidget::emphasizeCurrentEntry(const bool emphasized)
 {
     QListWidgetItem * const it = item(currentEntryIndex_);
@@ -379,7 +406,7 @@ void HistoryWidget::contextMenuEvent(QContextMenuEvent * const event)
     }
     CustomActions::showMenu(
         customActions_, std::move(commonPrefix), std::move(itemNames),
-        position, tooltipShower_);
+        position, tooltipShower_, customActionJobs_);
 }
 
 
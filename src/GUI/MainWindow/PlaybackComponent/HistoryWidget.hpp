@@ -45,9 +45,10 @@ public:
     /// @param playItems Function that starts playing ItemCollection
     /// parameter. If item(s) actually get(s) played, HistoryWidget must be
     /// notified about this via push() or playedMultipleItems().
-    /// NOTE: customActions must remain valid throughout this HistoryWidget's
-    /// lifetime.
+    /// NOTE: customActions and customActionJobs must remain valid throughout
+    /// this HistoryWidget's lifetime.
     explicit HistoryWidget(const CustomActions::Actions & customActions,
+                           CustomActions::JobScheduler & customActionJobs,
                            PlayExistingEntry playExistingEntry,
                            CommonTypes::PlayItems playItems,
                            const Preferences::Playback::History & preferences,
@@ -91,11 +92,23 @@ public:
 
     /// @brief Adds entry to the history and sets currentEntryIndex_ to 0.
     void push(std::string entry);
+    /// @brief Adds entries to the history in order, so that the last of them
+    /// becomes the most recent entry, and sets currentEntryIndex_ to 0.
+    /// Is equivalent to pushing entries one by one, but updates the list only
+    /// once.
+    void push(const CommonTypes::ItemCollection & entries);
 
     /// @brief Sets currentEntryIndex_ to
     /// Preferences::Playback::History::multipleItemsIndex.
     void playedMultipleItems();
 
+    /// @brief Passes each history entry to consume, starting from the most
+    /// recent one.
+    void forEachEntry(const CommonTypes::ItemConsumer & consume) const {
+        for (const std::string & entry : history_.items())
+            consume(entry);
+    }
+
     /// @return true if @p entry is among last @p recentEntryCount
     /// history entries.
     bool isRecentEntry(unsigned recentEntryCount,
@@ -107,7 +120,8 @@ public slots:
 
 signals:
     /// @brief Is emitted after history is changed via GUI (adding or manual
-    /// removing items in list widget) or clearHistory() slot.
+    /// removing items in list widget), clearHistory() slot or
+    /// setPreferences() that decreases history size below entry count.
     /// NOTE: execution may be blocked by signal receiver.
     void historyChanged();
 
@@ -119,6 +133,12 @@ private:
     /// (either by copying to top or just changing currentEntryIndex_) and
     /// returns its path; otherwise returns empty string.
     std::string setCurrentEntry(int index);
+    /// @brief Adds entry to history_ and to the top of the list without
+    /// removing extra items or updating emphasis.
+    void addEntry(std::string entry);
+    /// @brief Removes list items that exceed history_.maxSize(), scrolls to
+    /// the top and makes the most recent entry current.
+    void finishPushing();
 
     /// @brief Emphasizes/deemphasizes current entry if it exists.
     void emphasizeCurrentEntry(bool emphasized = true);
@@ -141,6 +161,7 @@ private:
 
 
     const CustomActions::Actions & customActions_;
+    CustomActions::JobScheduler & customActionJobs_;
     const PlayExistingEntry playExistingEntry_;
     const CommonTypes::PlayItems playItems_;
     History history_;
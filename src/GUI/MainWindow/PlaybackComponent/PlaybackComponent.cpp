@@ -31,12 +31,12 @@
 
 # include <CommonUtilities/ExceptionsToStderr.hpp>
 
+# include <QtGlobal>
 # include <QString>
 # include <QStringList>
 # include <QObject>
 # include <QTimer>
 # include <QFileInfo>
-# include <QProcess>
 # include <QAction>
 # include <QLabel>
 # include <QMessageBox>
@@ -45,6 +45,7 @@
 # include <QStatusBar>
 # include <QMainWindow>
 
+# include <cstddef>
 # include <utility>
 # include <functional>
 # include <tuple>
@@ -66,6 +67,29 @@ inline QString externalPlayerError()
     return externalPlayerErrors(false);
 }
 
+/// Item collections with greater total path length are passed to external
+/// player via temporary playlist file. This keeps command line within OS
+/// limits and spares the player parsing huge argument lists before starting
+/// playback.
+# ifdef Q_OS_WIN
+constexpr std::size_t maxDirectItemsLength = 16 * 1024;
+# else
+constexpr std::size_t maxDirectItemsLength = 64 * 1024;
+# endif
+
+/// @return true if items should be passed to external player via temporary
+/// playlist file.
+bool requiresTemporaryPlaylist(const CommonTypes::ItemCollection & items)
+{
+    std::size_t length = 0;
+    for (const std::string & item : items) {
+        length += item.size() + 1;
+        if (length > maxDirectItemsLength)
+            return true;
+    }
+    return false;
+}
+
 }
 
 
@@ -73,13 +97,15 @@ inline QString externalPlayerError()
 PlaybackComponent::PlaybackComponent(
     QMainWindow & mainWindow, const Actions::Playback & actions,
     QtUtilities::Widgets::InputController & inputController,
-    const Preferences & preferences, const std::string & preferencesDir,
-    bool & cancelled)
+    const Preferences & preferences,
+    CustomActions::JobScheduler & customActionJobs,
+    const std::string & preferencesDir, bool & cancelled)
     : mainWindow_(mainWindow), actions_(actions),
       inputController_(inputController),
       historyFilename_(preferencesDir + "history"),
+      temporaryPlaylist_(preferencesDir + "temporary-playlist.m3u"),
       playerId_(static_cast<unsigned>(GetMediaPlayer::playerList().size())),
-      historyWidget_(preferences.customActions,
+      historyWidget_(preferences.customActions, customActionJobs,
                      std::bind(& PlaybackComponent::playFromHistory, this,
                                std::placeholders::_1),
     [this](CommonTypes::ItemCollection items) { play(std::move(items)); },
@@ -167,12 +193,28 @@ void PlaybackComponent::play(CommonTypes::ItemCollection items)
 {
     if (items.size() == 1)
         play(std::move(items.back()));
-    else {
-        if (! mediaPlayer_->start(std::move(items)))
-            return;
-        historyWidget_.playedMultipleItems();
-        resetLastPlayedItem();
-        setStatus(Status::playing);
+    else if (startMultipleItems(std::move(items)))
+        startedMultipleItems();
+}
+
+void PlaybackComponent::playStreamed(
+    const CommonTypes::ItemProducer & produceItems)
+{
+    if (startTemporaryPlaylist(produceItems))
+        startedMultipleItems();
+}
+
+void PlaybackComponent::playPushingToHistory(
+    CommonTypes::ItemCollection items)
+{
+    if (items.size() == 1)
+        play(std::move(items.back()));
+    else if (startMultipleItems(items)) {
+        startedMultipleItems();
+        // Pushing makes the most recent of the pushed entries current instead
+        // of multipleItemsIndex set by startedMultipleItems().
+        historyWidget_.push(items);
+        onHistoryChanged();
     }
 }
 
@@ -279,12 +321,7 @@ void PlaybackComponent::resetLastPlayedItem(const bool playbackStarted)
             summary = historyWidget_.maxSize() == 0  ?
                       tr("<unknown item(s)>") : tr("<multiple items>");
         }
-        // replace special notify-send characters.
-        summary.replace('&', "&amp;");
-        summary.replace('<', "&lt;");
-        summary.replace('\\', "&#92;");
-        QProcess::startDetached("notify-send",
-        { "-a", APPLICATION_NAME, "-i", ICON_NAME, "|>", summary });
+        desktopNotifier_.notify(summary);
     }
 
     if (lastPlayedItemLabel_ == nullptr)
@@ -305,6 +342,38 @@ void PlaybackComponent::resetLastPlayedItem(const bool playbackStarted)
     }
 }
 
+bool PlaybackComponent::startMultipleItems(CommonTypes::ItemCollection items)
+{
+    if (requiresTemporaryPlaylist(items)) {
+        return startTemporaryPlaylist(
+        [&items](const CommonTypes::ItemConsumer & consume) {
+            for (const std::string & item : items)
+                consume(item);
+        });
+    }
+    return mediaPlayer_->start(std::move(items));
+}
+
+bool PlaybackComponent::startTemporaryPlaylist(
+    const CommonTypes::ItemProducer & produceItems)
+{
+    if (! temporaryPlaylist_.write(produceItems)) {
+        inputController_.showMessage(
+            tr("I/O error"),
+            tr("Could not write temporary playlist file %1.").arg(
+                QtUtilities::toQString(temporaryPlaylist_.filename())));
+        return false;
+    }
+    return mediaPlayer_->start(temporaryPlaylist_.filename());
+}
+
+void PlaybackComponent::startedMultipleItems()
+{
+    historyWidget_.playedMultipleItems();
+    resetLastPlayedItem();
+    setStatus(Status::playing);
+}
+
 void PlaybackComponent::setStatus(const Status status)
 {
     if (status_ != status) {
@@ -400,6 +469,7 @@ void PlaybackComponent::updateStatus()
 
 void PlaybackComponent::onHistoryChanged()
 {
+    emit historyChanged();
     isHistorySaved_ = false;
     if (saveHistoryToDiskImmediately_)
         saveHistory();
@@ -20,6 +20,8 @@
 # define VENTUROUS_PLAYBACK_COMPONENT_HPP
 
 # include "HistoryWidget.hpp"
+# include "TemporaryPlaylist.hpp"
+# include "DesktopNotifier.hpp"
 # include "CommonTypes.hpp"
 # include "Actions.hpp"
 
@@ -52,13 +54,15 @@ class PlaybackComponent : public QObject
 public:
     /// @param cancelled Is set to true if user has cancelled launching
     /// application (because of error); is set to false otherwise.
-    /// NOTE: mainWindow, actions, inputController and preferences must remain
-    /// valid throughout this PlaybackComponent's lifetime.
+    /// NOTE: mainWindow, actions, inputController, preferences and
+    /// customActionJobs must remain valid throughout this PlaybackComponent's
+    /// lifetime.
     explicit PlaybackComponent(
         QMainWindow & mainWindow, const Actions::Playback & actions,
         QtUtilities::Widgets::InputController & inputController,
-        const Preferences & preferences, const std::string & preferencesDir,
-        bool & cancelled);
+        const Preferences & preferences,
+        CustomActions::JobScheduler & customActionJobs,
+        const std::string & preferencesDir, bool & cancelled);
     /// NOTE: does not block execution.
     ~PlaybackComponent();
 
@@ -77,10 +81,27 @@ public:
         return historyWidget_.isRecentEntry(recentEntryCount, entry);
     }
 
+    /// @brief Passes each history entry to consume, starting from the most
+    /// recent one.
+    /// NOTE: does not block execution.
+    void forEachHistoryEntry(const CommonTypes::ItemConsumer & consume) const {
+        historyWidget_.forEachEntry(consume);
+    }
+
     /// @brief Starts playing item and pushes it to history.
     void play(std::string item);
     /// @brief Starts playing items and adjusts history.
+    /// Large collections are passed to external player via temporary
+    /// playlist file.
     void play(CommonTypes::ItemCollection items);
+    /// @brief Starts playing items passed by produceItems and adjusts history.
+    /// Items are written to temporary playlist file as they are produced, so
+    /// they are never stored in memory all at once.
+    void playStreamed(const CommonTypes::ItemProducer & produceItems);
+    /// @brief Starts playing items and pushes all of them to history.
+    /// The last of items becomes the current history entry.
+    /// History is changed (and saved if needed) only once.
+    void playPushingToHistory(CommonTypes::ItemCollection items);
 
     /// @brief If there is next item in history, starts playing it and returns
     /// true. Otherwise, does not block execution and returns false.
@@ -93,6 +114,9 @@ signals:
     /// status is always equal to status().
     /// WARNING: signal receiver may not block execution.
     void statusChanged(MediaPlayer::Status status);
+    /// @brief Is emitted after history entries might have changed.
+    /// WARNING: signal receiver may not block execution.
+    void historyChanged();
 
 private:
     using Status = MediaPlayer::Status;
@@ -120,6 +144,17 @@ private:
     /// NOTE: does not block execution.
     void resetLastPlayedItem(bool playbackStarted = true);
 
+    /// @brief Starts playing multiple items without adjusting history.
+    /// @return true if playback was started.
+    bool startMultipleItems(CommonTypes::ItemCollection items);
+    /// @brief Writes items passed by produceItems to temporary playlist file
+    /// and starts playing it without adjusting history.
+    /// @return true if playback was started.
+    bool startTemporaryPlaylist(const CommonTypes::ItemProducer & produceItems);
+    /// @brief Must be called after multiple items are started.
+    /// NOTE: does not block execution.
+    void startedMultipleItems();
+
     /// @brief If status_ != status, sets status_ to status and performs other
     /// accompanying actions.
     /// NOTE: does not block execution.
@@ -143,6 +178,7 @@ private:
     const Actions::Playback & actions_;
     QtUtilities::Widgets::InputController & inputController_;
     const std::string historyFilename_;
+    const TemporaryPlaylist temporaryPlaylist_;
 
     int statusUpdateInterval_ = 0;
     bool saveHistoryToDiskImmediately_;
@@ -154,6 +190,7 @@ private:
     unsigned playerId_;
     std::unique_ptr<MediaPlayer> mediaPlayer_;
 
+    DesktopNotifier desktopNotifier_;
     std::unique_ptr<QLabel> lastPlayedItemLabel_;
     HistoryWidget historyWidget_;
 
@@ -0,0 +1,42 @@
+/*
+ This file is part of Venturous.
+ Copyright (C) 2026 Igor Kushnir <igorkuo AT Google mail>
+
+ Venturous is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Venturous is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ Venturous.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# include "TemporaryPlaylist.hpp"
+
+# include "CommonTypes.hpp"
+
+# include <QtCoreUtilities/Miscellaneous.hpp>
+
+# include <fstream>
+# include <string>
+
+
+bool TemporaryPlaylist::write(
+    const CommonTypes::ItemProducer & produceItems) const
+{
+    QtUtilities::makePathTo(filename_);
+    std::ofstream file(filename_, std::ios_base::out | std::ios_base::trunc);
+    if (! file)
+        return false;
+    file << "#EXTM3U\n";
+    produceItems([&file](const std::string & item) {
+        file << item << '\n';
+    });
+    file.close();
+    return ! file.fail();
+}
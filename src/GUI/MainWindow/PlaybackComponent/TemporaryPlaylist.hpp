@@ -0,0 +1,48 @@
+/*
+ This file is part of Venturous.
+ Copyright (C) 2026 Igor Kushnir <igorkuo AT Google mail>
+
+ Venturous is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Venturous is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ Venturous.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef VENTUROUS_TEMPORARY_PLAYLIST_HPP
+# define VENTUROUS_TEMPORARY_PLAYLIST_HPP
+
+# include "CommonTypes.hpp"
+
+# include <utility>
+# include <string>
+
+
+/// M3U playlist file that is passed to external player instead of the items
+/// themselves. This way arbitrarily many items can be played without
+/// collecting them first or exceeding command line length limits.
+class TemporaryPlaylist
+{
+public:
+    explicit TemporaryPlaylist(std::string filename)
+        : filename_(std::move(filename)) {}
+
+    const std::string & filename() const { return filename_; }
+
+    /// @brief Overwrites playlist file with items passed by produceItems.
+    /// Items are written as soon as they are produced.
+    /// @return true if writing was successful.
+    bool write(const CommonTypes::ItemProducer & produceItems) const;
+
+private:
+    std::string filename_;
+};
+
+# endif // VENTUROUS_TEMPORARY_PLAYLIST_HPP
@@ -0,0 +1,70 @@
+/*
+ This file is part of Venturous.
+ Copyright (C) 2026 Igor Kushnir <igorkuo AT Google mail>
+
+ Venturous is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Venturous is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ Venturous.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# include "FenwickTree.hpp"
+
+# include <cstddef>
+# include <utility>
+# include <vector>
+
+
+FenwickTree::FenwickTree(std::vector<double> weights)
+    : weights_(std::move(weights)), tree_(weights_)
+{
+    const std::size_t n = tree_.size();
+    for (std::size_t j = 1; j <= n; ++j) {
+        const std::size_t parent = j + (j & (~j + 1));
+        if (parent <= n)
+            tree_[parent - 1] += tree_[j - 1];
+    }
+    if (n != 0) {
+        highestBit_ = 1;
+        while (highestBit_ <= n / 2)
+            highestBit_ *= 2;
+    }
+}
+
+void FenwickTree::set(const std::size_t i, const double weight)
+{
+    const double delta = weight - weights_[i];
+    weights_[i] = weight;
+    for (std::size_t j = i + 1; j <= tree_.size(); j += j & (~j + 1))
+        tree_[j - 1] += delta;
+}
+
+double FenwickTree::prefixSum(std::size_t i) const
+{
+    double sum = 0;
+    for (; i > 0; i -= i & (~i + 1))
+        sum += tree_[i - 1];
+    return sum;
+}
+
+std::size_t FenwickTree::find(double target) const
+{
+    std::size_t position = 0;
+    for (std::size_t step = highestBit_; step != 0; step /= 2) {
+        const std::size_t next = position + step;
+        if (next <= tree_.size() && tree_[next - 1] <= target) {
+            position = next;
+            target -= tree_[next - 1];
+        }
+    }
+    // Rounding errors can lead past the last element.
+    return position < size() ? position : size() - 1;
+}
@@ -0,0 +1,60 @@
+/*
+ This file is part of Venturous.
+ Copyright (C) 2026 Igor Kushnir <igorkuo AT Google mail>
+
+ Venturous is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Venturous is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ Venturous.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef VENTUROUS_FENWICK_TREE_HPP
+# define VENTUROUS_FENWICK_TREE_HPP
+
+# include <cstddef>
+# include <vector>
+
+
+/// Binary indexed tree over non-negative weights. Supports changing a weight,
+/// querying a prefix sum and finding the element that contains a point of the
+/// cumulative distribution in O(log(size())).
+class FenwickTree
+{
+public:
+    FenwickTree() = default;
+    /// Complexity: O(weights.size()).
+    explicit FenwickTree(std::vector<double> weights);
+
+    std::size_t size() const { return weights_.size(); }
+    double weight(std::size_t i) const { return weights_[i]; }
+
+    /// @brief Replaces weight of element i with weight.
+    void set(std::size_t i, double weight);
+
+    /// @return Sum of weights of elements [0, i).
+    double prefixSum(std::size_t i) const;
+    double total() const { return prefixSum(size()); }
+
+    /// @return The element i such that
+    /// prefixSum(i) <= target < prefixSum(i + 1).
+    /// NOTE: target must be in [0, total()), size() must be positive.
+    std::size_t find(double target) const;
+
+private:
+    std::vector<double> weights_;
+    /// tree_[i] is the sum of weights of elements (j - (j & -j), j], where
+    /// j = i + 1.
+    std::vector<double> tree_;
+    /// The greatest power of 2 that does not exceed size() or 0.
+    std::size_t highestBit_ = 0;
+};
+
+# endif // VENTUROUS_FENWICK_TREE_HPP
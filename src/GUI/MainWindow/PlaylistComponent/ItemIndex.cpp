@@ -0,0 +1,208 @@
+/*
+ This file is part of Venturous.
+ Copyright (C) 2026 Igor Kushnir <igorkuo AT Google mail>
+
+ Venturous is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Venturous is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ Venturous.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# include "ItemIndex.hpp"
+
+# include <VenturousCore/ItemTree.hpp>
+
+# include <QtCoreUtilities/String.hpp>
+
+# include <QString>
+
+# include <cstdint>
+# include <cstddef>
+# include <cctype>
+# include <algorithm>
+# include <vector>
+# include <string>
+
+
+namespace
+{
+constexpr std::size_t trigramSize = 3;
+
+inline std::uint32_t trigram(const char * s)
+{
+    return std::uint32_t(static_cast<unsigned char>(s[0])) << 16 |
+           std::uint32_t(static_cast<unsigned char>(s[1])) << 8 |
+           std::uint32_t(static_cast<unsigned char>(s[2]));
+}
+
+/// @brief Appends case-folded UTF-8 name to folded.
+void appendFolded(const std::string & name, std::string & folded)
+{
+    const bool ascii = std::all_of(name.begin(), name.end(), [](char c) {
+        return static_cast<unsigned char>(c) < 0x80;
+    });
+    if (ascii) {
+        for (const char c : name)
+            folded += char(std::tolower(static_cast<unsigned char>(c)));
+    }
+    else {
+        folded += QtUtilities::qStringToString(
+                      QtUtilities::toQString(name).toCaseFolded());
+    }
+}
+
+} // END unnamed namespace
+
+
+constexpr ItemIndex::NodeId ItemIndex::noNode;
+
+void ItemIndex::build(const ItemTree::Tree & tree)
+{
+    clear();
+    playableCounts_.push_back(0);
+    for (const ItemTree::Node & topLevelNode : tree.topLevelNodes())
+        add(topLevelNode, noNode);
+    nameOffsets_.push_back(foldedNames_.size());
+}
+
+void ItemIndex::clear()
+{
+    nodes_.clear();
+    parents_.clear();
+    subtreeEnds_.clear();
+    playableCounts_.clear();
+    foldedNames_.clear();
+    nameOffsets_.clear();
+    trigrams_.clear();
+}
+
+ItemIndex::NodeId ItemIndex::nthPlayable(const NodeId begin,
+                                        const NodeId n) const
+{
+    // The first element greater than target is right after the wanted node.
+    const NodeId target = playableCounts_[begin] + n;
+    const auto it = std::upper_bound(playableCounts_.begin() + begin + 1,
+                                     playableCounts_.end(), target);
+    return NodeId(it - playableCounts_.begin()) - 1;
+}
+
+std::string ItemIndex::path(NodeId id) const
+{
+    NodeIds ancestors;
+    for (; id != noNode; id = parent(id))
+        ancestors.push_back(id);
+    std::string result = nodes_[ancestors.back()]->name();
+    for (auto it = ancestors.crbegin() + 1; it != ancestors.crend(); ++it) {
+        result += '/';
+        result += nodes_[* it]->name();
+    }
+    return result;
+}
+
+ItemIndex::NodeIds ItemIndex::find(const QString & pattern) const
+{
+    const std::string folded =
+        QtUtilities::qStringToString(pattern.toCaseFolded());
+    NodeIds result;
+    if (folded.empty())
+        return result;
+
+    if (folded.size() < trigramSize) {
+        for (NodeId id = 0; id < nodeCount(); ++id) {
+            if (contains(id, folded))
+                result.push_back(id);
+        }
+        return result;
+    }
+
+    // Each match contains every trigram of pattern, so only nodes from the
+    // shortest list need to be checked.
+    const NodeIds * candidates = nullptr;
+    for (std::size_t i = 0; i + trigramSize <= folded.size(); ++i) {
+        const auto it = trigrams_.find(trigram(folded.data() + i));
+        if (it == trigrams_.end())
+            return result;
+        if (candidates == nullptr || it->second.size() < candidates->size())
+            candidates = & it->second;
+    }
+    for (const NodeId id : * candidates) {
+        if (contains(id, folded))
+            result.push_back(id);
+    }
+    return result;
+}
+
+
+void ItemIndex::add(const ItemTree::Node & node, const NodeId parent)
+{
+    const NodeId id = nodeCount();
+    nodes_.push_back(& node);
+    parents_.push_back(parent);
+    subtreeEnds_.push_back(id);
+    playableCounts_.push_back(playableCounts_.back() +
+                              (node.isPlayable() ? 1 : 0));
+
+    const std::size_t nameBegin = foldedNames_.size();
+    nameOffsets_.push_back(nameBegin);
+    appendFolded(node.name(), foldedNames_);
+    for (std::size_t i = nameBegin; i + trigramSize <= foldedNames_.size();
+            ++i) {
+        NodeIds & ids = trigrams_[trigram(foldedNames_.data() + i)];
+        // Ids are added in ascending order, so a repeated trigram of the same
+        // name can only be at the back.
+        if (ids.empty() || ids.back() != id)
+            ids.push_back(id);
+    }
+
+    for (const ItemTree::Node & child : node.children())
+        add(child, id);
+    subtreeEnds_[id] = nodeCount();
+}
+
+bool ItemIndex::contains(const NodeId id,
+                         const std::string & foldedPattern) const
+{
+    const char * const begin = foldedNames_.data() + nameOffsets_[id];
+    const char * const end = foldedNames_.data() + nameOffsets_[id + 1];
+    return std::search(begin, end, foldedPattern.begin(), foldedPattern.end())
+           != end;
+}
+
+
+ItemSubset::ItemSubset(const ItemIndex & index,
+                       const ItemIndex::NodeIds & matches)
+    : index_(& index)
+{
+    std::size_t count = 0;
+    for (const ItemIndex::NodeId id : matches) {
+        // Descendants of the previous match are already included.
+        if (! ranges_.empty() && id < ranges_.back().second)
+            continue;
+        const ItemIndex::NodeId end = index.subtreeEnd(id);
+        const ItemIndex::NodeId rangeCount = index.playableCount(id, end);
+        if (rangeCount == 0)
+            continue;
+        ranges_.emplace_back(id, end);
+        count += rangeCount;
+        cumulativeCounts_.push_back(count);
+    }
+}
+
+ItemIndex::NodeId ItemSubset::item(const std::size_t n) const
+{
+    const std::size_t range = std::size_t(
+        std::upper_bound(cumulativeCounts_.begin(), cumulativeCounts_.end(), n)
+        - cumulativeCounts_.begin());
+    const std::size_t precedingCount =
+        range == 0 ? 0 : cumulativeCounts_[range - 1];
+    return index_->nthPlayable(ranges_[range].first,
+                               ItemIndex::NodeId(n - precedingCount));
+}
@@ -0,0 +1,159 @@
+/*
+ This file is part of Venturous.
+ Copyright (C) 2026 Igor Kushnir <igorkuo AT Google mail>
+
+ Venturous is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Venturous is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ Venturous.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef VENTUROUS_ITEM_INDEX_HPP
+# define VENTUROUS_ITEM_INDEX_HPP
+
+# include <QString>
+
+# include <cstdint>
+# include <cstddef>
+# include <utility>
+# include <unordered_map>
+# include <vector>
+# include <string>
+
+
+namespace ItemTree
+{
+class Node;
+class Tree;
+}
+
+/// Flat snapshot of ItemTree::Tree structure with a trigram index over
+/// case-folded node names. Allows to find nodes by a part of their name
+/// without visiting the whole tree.
+/// Nodes are identified by their numbers in pre-order traversal, so each
+/// subtree occupies a contiguous range of ids.
+/// NOTE: index is not updated automatically. It refers to nodes of the
+/// indexed tree, so build() must be called again after the tree is modified.
+/// Playable state of nodes is captured by build().
+class ItemIndex
+{
+public:
+    using NodeId = std::uint32_t;
+    using NodeIds = std::vector<NodeId>;
+    /// Parent id of top-level nodes.
+    static constexpr NodeId noNode = NodeId(-1);
+
+    /// @brief Replaces index contents with a snapshot of tree.
+    /// Complexity: O(total length of node names).
+    void build(const ItemTree::Tree & tree);
+    void clear();
+
+    NodeId nodeCount() const { return NodeId(parents_.size()); }
+
+    NodeId parent(NodeId id) const { return parents_[id]; }
+    /// @return One past the id of the last descendant of node id.
+    NodeId subtreeEnd(NodeId id) const { return subtreeEnds_[id]; }
+
+    bool isPlayable(NodeId id) const {
+        return playableCounts_[id + 1] != playableCounts_[id];
+    }
+    /// @return Number of playable nodes with ids in [begin, end).
+    NodeId playableCount(NodeId begin, NodeId end) const {
+        return playableCounts_[end] - playableCounts_[begin];
+    }
+    /// @return Id of the playable node that is preceded by exactly n playable
+    /// nodes with ids in [begin, id).
+    /// NOTE: n must be less than playableCount(begin, nodeCount()).
+    /// Complexity: O(log(nodeCount())).
+    NodeId nthPlayable(NodeId begin, NodeId n) const;
+
+    /// @return Absolute path of node id.
+    /// Complexity: O(length of the path).
+    std::string path(NodeId id) const;
+
+    /// @return Sorted ids of nodes whose names contain pattern, ignoring case.
+    /// Complexity: proportional to the number of nodes that contain the
+    /// rarest trigram of pattern; linear in total name length if pattern is
+    /// shorter than a trigram.
+    NodeIds find(const QString & pattern) const;
+
+private:
+    /// @brief Appends node and its descendants to the index.
+    void add(const ItemTree::Node & node, NodeId parent);
+    /// @return true if name of node id contains foldedPattern.
+    bool contains(NodeId id, const std::string & foldedPattern) const;
+
+
+    std::vector<const ItemTree::Node *> nodes_;
+    NodeIds parents_;
+    NodeIds subtreeEnds_;
+    /// Number of playable nodes with ids less than index of each element.
+    /// Has nodeCount() + 1 elements.
+    NodeIds playableCounts_;
+    /// Case-folded names of all nodes, concatenated in id order.
+    std::string foldedNames_;
+    /// Offsets of names in foldedNames_, followed by foldedNames_.size().
+    std::vector<std::size_t> nameOffsets_;
+    /// Maps each trigram to sorted ids of nodes whose names contain it.
+    std::unordered_map<std::uint32_t, NodeIds> trigrams_;
+};
+
+
+/// Playable nodes of ItemIndex that match some condition: matching nodes and
+/// their descendants. Allows to pick any of these nodes by its number in
+/// logarithmic time, which makes uniform random selection among them cheap.
+class ItemSubset
+{
+public:
+    ItemSubset() = default;
+    /// @param matches Sorted ids of matching nodes.
+    /// NOTE: index must remain valid and unchanged throughout this
+    /// ItemSubset's lifetime.
+    /// Complexity: O(matches.size()).
+    explicit ItemSubset(const ItemIndex & index,
+                        const ItemIndex::NodeIds & matches);
+
+    /// @return Number of playable nodes in this subset.
+    std::size_t itemCount() const {
+        return cumulativeCounts_.empty() ? 0 : cumulativeCounts_.back();
+    }
+
+    /// @return Id of playable node number n in tree order.
+    /// NOTE: n must be less than itemCount().
+    /// Complexity: O(log(matches.size()) + log(index.nodeCount())).
+    ItemIndex::NodeId item(std::size_t n) const;
+
+    /// @brief Passes ids of all playable nodes of this subset to f in tree
+    /// order.
+    template <typename F>
+    void forEachItem(F f) const;
+
+private:
+    const ItemIndex * index_ = nullptr;
+    /// Disjoint ranges of node ids in ascending order.
+    std::vector<std::pair<ItemIndex::NodeId, ItemIndex::NodeId>> ranges_;
+    /// Number of playable nodes in ranges_[0..i] for each i.
+    std::vector<std::size_t> cumulativeCounts_;
+};
+
+
+template <typename F>
+void ItemSubset::forEachItem(F f) const
+{
+    for (const auto & range : ranges_) {
+        for (ItemIndex::NodeId id = range.first; id < range.second; ++id) {
+            if (index_->isPlayable(id))
+                f(id);
+        }
+    }
+}
+
+# endif // VENTUROUS_ITEM_INDEX_HPP
@@ -25,6 +25,7 @@
 # include "CommonTypes.hpp"
 # include "Actions.hpp"
 # include "Preferences.hpp"
+# include "RandomNumbers.hpp"
 
 # include <VenturousCore/ItemTree-inl.hpp>
 # include <VenturousCore/AddingItems.hpp>
@@ -37,18 +38,30 @@
 
 # include <CommonUtilities/ExceptionsToStderr.hpp>
 
+# include <QtGlobal>
+# include <QByteArray>
 # include <QString>
 # include <QStringList>
 # include <QObject>
+# include <QTimer>
 # include <QFile>
 # include <QFileInfo>
 # include <QAction>
+# include <QLineEdit>
+# include <QCheckBox>
+# include <QHBoxLayout>
+# include <QVBoxLayout>
 # include <QMessageBox>
 # include <QFileDialog>
 # include <QMainWindow>
 
+# include <cstdint>
+# include <cstddef>
 # include <utility>
 # include <algorithm>
+# include <random>
+# include <unordered_set>
+# include <vector>
 # include <string>
 
 
@@ -71,6 +84,72 @@ inline const QString & editModeTitle()
     return s;
 }
 
+/// Number of random items that are chosen in advance.
+constexpr std::size_t prefetchedRandomItemCount = 3;
+/// @brief Reads seed from VENTUROUS_RANDOM_SEED environment variable.
+/// @return true if the variable contains a valid seed.
+bool readFixedRandomSeed(std::mt19937::result_type & seed)
+{
+    const QByteArray value = qgetenv("VENTUROUS_RANDOM_SEED");
+    if (value.isEmpty())
+        return false;
+    bool ok;
+    const qulonglong number = value.toULongLong(& ok);
+    if (! ok || number > std::mt19937::max()) {
+# ifdef DEBUG_VENTUROUS_PLAYLIST_COMPONENT
+        std::cout << "Ignored invalid random seed: " << value.constData()
+                  << std::endl;
+# endif
+        return false;
+    }
+    seed = std::mt19937::result_type(number);
+    return true;
+}
+
+/// @return Position of item in the shuffled order that is defined by seed.
+/// Is a 64-bit FNV-1a hash of item path finalized with SplitMix64 mixing.
+std::uint64_t shuffleKey(const std::string & item, const std::uint64_t seed)
+{
+    std::uint64_t hash = 14695981039346656037ull ^ seed;
+    for (const char c : item) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ull;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebull;
+    hash ^= hash >> 31;
+    return hash;
+}
+
+/// @brief Passes absolute paths of node (if it is playable) and of all its
+/// playable descendants to consume in tree order.
+/// @param path Absolute path to node's parent followed by '/' or empty string
+/// for top-level node. Is used as a buffer and restored before returning.
+void forEachPlayableItem(const ItemTree::Node & node, std::string & path,
+                         const CommonTypes::ItemConsumer & consume)
+{
+    const std::size_t parentPathSize = path.size();
+    path += node.name();
+    if (node.isPlayable())
+        consume(path);
+    path += '/';
+    for (const ItemTree::Node & child : node.children())
+        forEachPlayableItem(child, path, consume);
+    path.resize(parentPathSize);
+}
+
+/// @brief Passes absolute paths of all playable items in tree to consume
+/// without collecting them.
+void forEachPlayableItem(const ItemTree::Tree & tree,
+                         const CommonTypes::ItemConsumer & consume)
+{
+    std::string path;
+    for (const ItemTree::Node & topLevelNode : tree.topLevelNodes())
+        forEachPlayableItem(topLevelNode, path, consume);
+}
+
 }
 
 
@@ -78,27 +157,62 @@ PlaylistComponent::PlaylistComponent(
     QMainWindow & mainWindow, const Actions & actions,
     QtUtilities::Widgets::InputController & inputController,
     const Preferences & preferences,
+    CustomActions::JobScheduler & customActionJobs,
     IsRecentHistoryEntry isRecentHistoryEntry,
+    CommonTypes::ItemProducer historyEntries,
     CommonTypes::PlayItems playItems,
+    CommonTypes::PlayStreamedItems playStreamedItems,
+    CommonTypes::PlayItems playItemsPushingToHistory,
     const std::string & preferencesDir, bool & cancelled)
     : actions_(actions), inputController_(inputController),
       addingPatterns_(preferences.addingPatterns),
       addingPolicy_(preferences.addingPolicy),
       skipRecentHistoryItemCount_(
           preferences.playback.skipRecentHistoryItemCount),
+      fullShuffle_(preferences.playback.fullShuffle),
+      shuffleSeed_(preferences.playback.shuffleSeed),
+      shuffleCursor_(preferences.playback.shuffleCursor),
+      randomWeighting_(preferences.playback.randomWeighting),
+      randomBatchSize_(preferences.playback.randomBatchSize),
       isRecentHistoryEntry_(std::move(isRecentHistoryEntry)),
+      historyEntries_(std::move(historyEntries)),
       playItems_(std::move(playItems)),
+      playStreamedItems_(std::move(playStreamedItems)),
+      playItemsPushingToHistory_(std::move(playItemsPushingToHistory)),
       itemsFilename_(preferencesDir + "items"),
       qItemsFilename_(QtUtilities::toQString(itemsFilename_)),
       qBackupItemsFilename_(qItemsFilename_ + ".backup"),
       treeAutoCleanup_(preferences.treeAutoCleanup),
       treeWidget_(itemTree_, temporaryTree_, preferences.customActions,
-                  playItems_)
+                  customActionJobs, playItems_)
 {
 # ifdef DEBUG_VENTUROUS_PLAYLIST_COMPONENT
     std::cout << "itemsFilename_ = " << itemsFilename_ << std::endl;
 # endif
     treeWidget_.setAutoUnfoldedLevels(preferences.treeAutoUnfoldedLevels);
+    {
+        std::mt19937::result_type seed;
+        if (readFixedRandomSeed(seed)) {
+            fixedRandomSeed_ = true;
+            randomEngine_.seed(seed);
+# ifdef DEBUG_VENTUROUS_PLAYLIST_COMPONENT
+            std::cout << "Random seed = " << seed << std::endl;
+# endif
+        }
+    }
+    if (fixedRandomSeed_) {
+        // Fixed random seed must reproduce the same shuffle order regardless
+        // of saved state. The saved position remains valid only if the order
+        // is the same.
+        const std::uint64_t savedSeed = shuffleSeed_;
+        const std::uint64_t savedCursor = shuffleCursor_;
+        startShuffleCycle();
+        if (shuffleSeed_ == savedSeed)
+            shuffleCursor_ = savedCursor;
+    }
+    // Zero seed means that shuffle order was never used.
+    else if (shuffleSeed_ == 0)
+        startShuffleCycle();
 
     if (QFileInfo(qItemsFilename_).isFile()) {
         if (QtUtilities::Widgets::HandleErrors {
@@ -121,12 +235,39 @@ PlaylistComponent::PlaylistComponent(
     else
         cancelled = false;
 
-    mainWindow.setCentralWidget(& treeWidget_);
+    filterEdit_.setPlaceholderText(tr("Filter playlist"));
+    filterEdit_.setToolTip(tr("Press Enter to play all filtered items."));
+# if QT_VERSION >= 0x050200
+    filterEdit_.setClearButtonEnabled(true);
+# endif
+    randomFromFilteredCheckBox_.setText(tr("Random from filtered"));
+    randomFromFilteredCheckBox_.setToolTip(
+        tr("Choose next random item only among filtered items."));
+    {
+        QHBoxLayout * const filterLayout = new QHBoxLayout;
+        filterLayout->addWidget(& filterEdit_);
+        filterLayout->addWidget(& randomFromFilteredCheckBox_);
+        QVBoxLayout * const layout = new QVBoxLayout(& centralWidget_);
+        layout->setContentsMargins(0, 0, 0, 0);
+        layout->addLayout(filterLayout);
+        layout->addWidget(& treeWidget_);
+    }
+    mainWindow.setCentralWidget(& centralWidget_);
+    connect(& readAheadThread_, SIGNAL(itemMissing(QString)),
+            SLOT(onPrefetchedItemMissing(QString)));
+    connect(& filterEdit_, SIGNAL(textChanged(QString)),
+            SLOT(onFilterChanged(QString)));
+    connect(& filterEdit_, SIGNAL(returnPressed()),
+            SLOT(playFilteredItems()));
+    connect(& randomFromFilteredCheckBox_, SIGNAL(toggled(bool)),
+            SLOT(onRandomFromFilteredToggled()));
 
     connect(actions.playback.nextRandom, SIGNAL(triggered(bool)),
             SLOT(playbackNextRandom()));
     connect(actions.playback.playAll, SIGNAL(triggered(bool)),
             SLOT(playbackPlayAll()));
+    connect(actions.playback.playRandomBatch, SIGNAL(triggered(bool)),
+            SLOT(playbackPlayRandomBatch()));
 
     {
         const Actions::Playlist & p = actions.playlist;
@@ -146,6 +287,7 @@ PlaylistComponent::PlaylistComponent(
 
         connect(p.load, SIGNAL(triggered(bool)), SLOT(onLoad()));
         connect(p.saveAs, SIGNAL(triggered(bool)), SLOT(onSaveAs()));
+        connect(p.find, SIGNAL(triggered(bool)), SLOT(onFind()));
     }
 
     updateActionsState();
@@ -157,25 +299,46 @@ PlaylistComponent::~PlaylistComponent()
         if (treeWidget_.editMode() && ! noChanges())
             saveTemporaryTree();
     }, VENTUROUS_ERROR_PREFIX "In ~PlaylistComponent(): ");
+# ifdef DEBUG_VENTUROUS_PLAYLIST_COMPONENT
+    std::cout << "Random items chosen: " << randomPickCount_
+              << ", rejected as recent: " << rejectedRandomPickCount_
+              << std::endl;
+# endif
 }
 
 void PlaylistComponent::setPreferences(const Preferences & preferences)
 {
     skipRecentHistoryItemCount_ =
             preferences.playback.skipRecentHistoryItemCount;
+    if (preferences.playback.fullShuffle != fullShuffle_) {
+        fullShuffle_ = preferences.playback.fullShuffle;
+        prefetchedRandomItems_.clear();
+    }
+    if (preferences.playback.randomWeighting != randomWeighting_) {
+        randomWeighting_ = preferences.playback.randomWeighting;
+        weightedItemsValid_ = false;
+        prefetchedRandomItems_.clear();
+    }
+    randomBatchSize_ = preferences.playback.randomBatchSize;
     treeWidget_.setAutoUnfoldedLevels(preferences.treeAutoUnfoldedLevels);
     treeAutoCleanup_ = preferences.treeAutoCleanup;
 }
 
 bool PlaylistComponent::playRandomItem()
 {
-    if (itemTree_.itemCount() > 0) {
+    if (randomItemCount() > 0) {
         playItems_( { getNextRandomItem() });
+        QTimer::singleShot(0, this, SLOT(prefetchRandomItems()));
         return true;
     }
     return false;
 }
 
+void PlaylistComponent::historyChanged()
+{
+    weightedItemsHistoryOutdated_ = true;
+}
+
 bool PlaylistComponent::quit()
 {
     return ! treeWidget_.editMode() || noChanges() || leaveAskChangedEditMode();
@@ -211,6 +374,7 @@ bool PlaylistComponent::applyChangesChanged()
     if (cancelled)
         return false;
     itemTree_ = std::move(* temporaryTree_);
+    itemTreeChanged();
     cancelChanges(false);
     return true;
 }
@@ -288,31 +452,335 @@ bool PlaylistComponent::ensureAskOutOfEditMode()
     return treeWidget_.editMode() ? leaveAskEditMode() : true;
 }
 
-std::string PlaylistComponent::getNextRandomItem()
+void PlaylistComponent::itemTreeChanged()
+{
+    prefetchedRandomItems_.clear();
+    itemIndexValid_ = false;
+}
+
+bool PlaylistComponent::randomFromFiltered() const
+{
+    return randomFromFilteredCheckBox_.isChecked()
+           && ! filterEdit_.text().isEmpty();
+}
+
+void PlaylistComponent::ensureValidItemIndex()
+{
+    if (itemIndexValid_)
+        return;
+    itemIndex_.build(itemTree_);
+    itemIndexValid_ = true;
+    filteredItemsValid_ = false;
+    weightedItemsValid_ = false;
+    shuffleOrderValid_ = false;
+}
+
+const ItemSubset & PlaylistComponent::filteredItems()
+{
+    ensureValidItemIndex();
+    if (! filteredItemsValid_) {
+        filteredItems_ = ItemSubset(itemIndex_,
+                                    itemIndex_.find(filterEdit_.text()));
+        filteredItemsValid_ = true;
+        if (shuffleOrderFiltered_)
+            shuffleOrderValid_ = false;
+# ifdef DEBUG_VENTUROUS_PLAYLIST_COMPONENT
+        std::cout << "Filtered item count = " << filteredItems_.itemCount()
+                  << std::endl;
+# endif
+    }
+    return filteredItems_;
+}
+
+const WeightedItemChooser & PlaylistComponent::weightedItems()
+{
+    ensureValidItemIndex();
+    if (! weightedItemsValid_) {
+        weightedItems_.build(itemIndex_, randomWeighting_, historyEntries_);
+        weightedItemsValid_ = true;
+        weightedItemsHistoryOutdated_ = false;
+    }
+    else if (weightedItemsHistoryOutdated_) {
+        weightedItems_.historyChanged(historyEntries_);
+        weightedItemsHistoryOutdated_ = false;
+    }
+    return weightedItems_;
+}
+
+std::size_t PlaylistComponent::randomItemCount()
+{
+    return randomFromFiltered() ? filteredItems().itemCount()
+           : std::size_t(itemTree_.itemCount());
+}
+
+void PlaylistComponent::forEachRandomCandidate(
+    const CommonTypes::ItemConsumer & consume)
+{
+    if (randomFromFiltered()) {
+        filteredItems().forEachItem([&](ItemIndex::NodeId id) {
+            consume(itemIndex_.path(id));
+        });
+    }
+    else
+        forEachPlayableItem(itemTree_, consume);
+}
+
+void PlaylistComponent::startShuffleCycle()
+{
+    do {
+        shuffleSeed_ = std::uint64_t(randomEngine_()) << 32 | randomEngine_();
+    }
+    while (shuffleSeed_ == 0);
+    shuffleCursor_ = 0;
+    shuffleOrderValid_ = false;
+# ifdef DEBUG_VENTUROUS_PLAYLIST_COMPONENT
+    std::cout << "New shuffle cycle, seed = " << std::hex << shuffleSeed_
+              << std::dec << std::endl;
+# endif
+}
+
+const PlaylistComponent::ShuffleOrder & PlaylistComponent::shuffleOrder()
+{
+    const bool filtered = randomFromFiltered();
+    // filteredItems() and ensureValidItemIndex() can invalidate shuffleOrder_.
+    if (filtered)
+        filteredItems();
+    else
+        ensureValidItemIndex();
+    if (shuffleOrderValid_ && shuffleOrderFiltered_ == filtered)
+        return shuffleOrder_;
+
+    shuffleOrder_.clear();
+    const auto add = [this](const ItemIndex::NodeId id) {
+        shuffleOrder_.emplace_back(shuffleKey(itemIndex_.path(id),
+                                              shuffleSeed_), id);
+    };
+    if (filtered)
+        filteredItems_.forEachItem(add);
+    else {
+        for (ItemIndex::NodeId id = 0; id < itemIndex_.nodeCount(); ++id) {
+            if (itemIndex_.isPlayable(id))
+                add(id);
+        }
+    }
+    std::sort(shuffleOrder_.begin(), shuffleOrder_.end());
+    shuffleOrderValid_ = true;
+    shuffleOrderFiltered_ = filtered;
+# ifdef DEBUG_VENTUROUS_PLAYLIST_COMPONENT
+    std::cout << "Shuffle order of " << shuffleOrder_.size()
+              << " items is built." << std::endl;
+# endif
+    return shuffleOrder_;
+}
+
+PlaylistComponent::ShuffledItems PlaylistComponent::nextShuffledItems(
+    const std::uint64_t after, const std::size_t count)
+{
+    ShuffledItems next;
+    const ShuffleOrder & order = shuffleOrder();
+    auto it = std::upper_bound(
+        order.begin(), order.end(), after,
+        [](std::uint64_t key, const ShuffleOrder::value_type & i) {
+            return key < i.first;
+        });
+    for (; it != order.end() && next.size() < count; ++it)
+        next.emplace_back(it->first, itemIndex_.path(it->second));
+    return next;
+}
+
+std::string PlaylistComponent::nextShuffledItem()
+{
+    ShuffledItems next = nextShuffledItems(shuffleCursor_, 1);
+    if (next.empty()) {
+        // Each item was played in this cycle. Play them again in a new order.
+        startShuffleCycle();
+        next = nextShuffledItems(shuffleCursor_, 1);
+    }
+    return std::move(next.front().second);
+}
+
+unsigned PlaylistComponent::recentItemCount()
 {
     // When recentEntryCount is close to the total tree item count, the
     // performance of this function can randomly degrade due to many successive
     // history searches. Let maxRecentEntryCount be substantially lower than
     // the total item count to limit the impact on performance.
-    const auto maxRecentItemCount = 0.8 * itemTree_.itemCount();
+    const auto maxRecentItemCount = 0.8 * randomItemCount();
     const auto recentEntryCount = std::min(
                     skipRecentHistoryItemCount_,
                     static_cast<unsigned>(maxRecentItemCount));
 # ifdef DEBUG_VENTUROUS_PLAYLIST_COMPONENT
     std::cout << "recentEntryCount = " << recentEntryCount << std::endl;
 # endif
+    return recentEntryCount;
+}
+
+std::string PlaylistComponent::chooseRandomItem(const unsigned recentEntryCount)
+{
+    const bool filtered = randomFromFiltered();
+    const bool weighted = randomWeighting_ !=
+                          Preferences::Playback::RandomWeighting::uniform;
     std::string item;
-    do {
-        item = randomItemChooser_.randomPath(itemTree_);
+    unsigned rejectedCount = 0;
+    while (true) {
+        if (filtered) {
+            const ItemSubset & items = filteredItems();
+            item = itemIndex_.path(items.item(RandomNumbers::index(
+                                       randomEngine_, items.itemCount())));
+        }
+        else if (weighted) {
+            item = itemIndex_.path(
+                       weightedItems().randomItem(randomEngine_));
+        }
+        else if (fixedRandomSeed_) {
+            // randomItemChooser_ has its own random engine, which can not be
+            // seeded.
+            ensureValidItemIndex();
+            const ItemIndex::NodeId n = RandomNumbers::index(
+                randomEngine_,
+                itemIndex_.playableCount(0, itemIndex_.nodeCount()));
+            item = itemIndex_.path(itemIndex_.nthPlayable(0, n));
+        }
+        else
+            item = randomItemChooser_.randomPath(itemTree_);
+        ++randomPickCount_;
 # ifdef DEBUG_VENTUROUS_PLAYLIST_COMPONENT
         std::cout << "Random filename: "
                   << item.substr(item.find_last_of('/') + 1) << std::endl;
 # endif
+        if (! isRecentHistoryEntry_(recentEntryCount, item))
+            break;
+        ++rejectedCount;
     }
-    while (isRecentHistoryEntry_(recentEntryCount, item));
+    rejectedRandomPickCount_ += rejectedCount;
+# ifdef DEBUG_VENTUROUS_PLAYLIST_COMPONENT
+    std::cout << "Rejected recent random items: " << rejectedCount << std::endl;
+# endif
     return item;
 }
 
+std::string PlaylistComponent::getNextRandomItem()
+{
+    if (fullShuffle_) {
+        std::string item;
+        if (prefetchedRandomItems_.empty())
+            item = nextShuffledItem();
+        else {
+            item = std::move(prefetchedRandomItems_.front());
+            prefetchedRandomItems_.pop_front();
+        }
+        shuffleCursor_ = shuffleKey(item, shuffleSeed_);
+        return item;
+    }
+    const unsigned recentEntryCount = recentItemCount();
+    // History could have changed since prefetching, so check again.
+    while (! prefetchedRandomItems_.empty()) {
+        std::string item = std::move(prefetchedRandomItems_.front());
+        prefetchedRandomItems_.pop_front();
+        if (! isRecentHistoryEntry_(recentEntryCount, item))
+            return item;
+        ++rejectedRandomPickCount_;
+    }
+    return chooseRandomItem(recentEntryCount);
+}
+
+CommonTypes::ItemCollection PlaylistComponent::chooseRandomItems(
+    std::size_t count)
+{
+    CommonTypes::ItemCollection items;
+    const std::size_t candidateCount = randomItemCount();
+    if (fullShuffle_) {
+        count = std::min(count, candidateCount);
+        // Prefetched items are the first ones after shuffleCursor_.
+        prefetchedRandomItems_.clear();
+        ShuffledItems next = nextShuffledItems(shuffleCursor_, count);
+        std::unordered_set<std::string> chosen;
+        for (auto & item : next) {
+            chosen.insert(item.second);
+            items.push_back(std::move(item.second));
+        }
+        if (items.size() < count) {
+            // The cycle is over. Take the rest from the beginning of a new
+            // cycle, skipping items that have just been chosen. Each of them
+            // can be among the keys of the new cycle, so as many extra keys
+            // are requested. shuffleCursor_ is advanced only past the keys
+            // that were actually consumed.
+            startShuffleCycle();
+            for (auto & item : nextShuffledItems(shuffleCursor_,
+                                                 count + items.size())) {
+                if (items.size() == count)
+                    break;
+                shuffleCursor_ = item.first;
+                if (chosen.find(item.second) == chosen.end())
+                    items.push_back(std::move(item.second));
+            }
+        }
+        else if (! items.empty())
+            shuffleCursor_ = next.back().first;
+        return items;
+    }
+
+    const unsigned recentEntryCount = recentItemCount();
+    // recentItemCount() never exceeds candidateCount, and there are at least
+    // (candidateCount - recentEntryCount) distinct not recent candidates.
+    count = std::min(count, candidateCount - recentEntryCount);
+    std::unordered_set<std::string> chosen;
+    const auto choose = [&](std::string item) {
+        if (chosen.insert(item).second)
+            items.push_back(std::move(item));
+    };
+    while (items.size() < count && ! prefetchedRandomItems_.empty()) {
+        std::string item = std::move(prefetchedRandomItems_.front());
+        prefetchedRandomItems_.pop_front();
+        if (isRecentHistoryEntry_(recentEntryCount, item))
+            ++rejectedRandomPickCount_;
+        else
+            choose(std::move(item));
+    }
+    // Choosing random items one by one respects filtering and weights and is
+    // fast while most candidates are not chosen yet. As the batch approaches
+    // the number of candidates, repeated choices become more and more
+    // frequent, so the rest is sampled in a single pass.
+    for (std::size_t attempts = 2 * count;
+            items.size() < count && attempts > 0; --attempts) {
+        choose(chooseRandomItem(recentEntryCount));
+    }
+    if (items.size() < count)
+        sampleRemainingItems(count, recentEntryCount, chosen, items);
+    return items;
+}
+
+void PlaylistComponent::sampleRemainingItems(
+    const std::size_t count, const unsigned recentEntryCount,
+    const std::unordered_set<std::string> & chosen,
+    CommonTypes::ItemCollection & items)
+{
+    const std::size_t first = items.size();
+    std::uint32_t seenCount = 0;
+    // Reservoir sampling keeps a uniform random subset of the seen items.
+    forEachRandomCandidate([&](const std::string & item) {
+        if (chosen.find(item) != chosen.end()
+                || isRecentHistoryEntry_(recentEntryCount, item)) {
+            return;
+        }
+        ++seenCount;
+        if (items.size() < count)
+            items.push_back(item);
+        else {
+            const std::uint32_t i =
+                RandomNumbers::index(randomEngine_, seenCount);
+            if (i < count - first)
+                items[first + i] = item;
+        }
+    });
+    // Sampled items are in tree order, so shuffle them.
+    for (std::size_t n = items.size() - first; n > 1; --n) {
+        const std::size_t j = RandomNumbers::index(randomEngine_,
+                                                   std::uint32_t(n));
+        std::swap(items[first + n - 1], items[first + j]);
+    }
+}
+
 bool PlaylistComponent::makeBackup() const
 {
     QFile::remove(qBackupItemsFilename_);
@@ -377,19 +845,112 @@ void PlaylistComponent::loadTemporaryPlaylist(FilenameGetter filenameGetter)
 }
 
 
+void PlaylistComponent::onFind()
+{
+    filterEdit_.setFocus();
+    filterEdit_.selectAll();
+}
+
+void PlaylistComponent::onFilterChanged(const QString & filter)
+{
+    treeWidget_.setFilter(filter);
+    filteredItemsValid_ = false;
+    if (randomFromFilteredCheckBox_.isChecked())
+        prefetchedRandomItems_.clear();
+}
+
+void PlaylistComponent::onRandomFromFilteredToggled()
+{
+    prefetchedRandomItems_.clear();
+}
+
+void PlaylistComponent::playFilteredItems()
+{
+    if (filterEdit_.text().isEmpty() || filteredItems().itemCount() == 0)
+        return;
+    playStreamedItems_([this](const CommonTypes::ItemConsumer & consume) {
+        filteredItems_.forEachItem([&](ItemIndex::NodeId id) {
+            consume(itemIndex_.path(id));
+        });
+    });
+}
+
 void PlaylistComponent::playbackNextRandom()
 {
     if (! playRandomItem())
         actions_.playback.stop->trigger();
 }
 
+void PlaylistComponent::playbackPlayRandomBatch()
+{
+    CommonTypes::ItemCollection items = chooseRandomItems(randomBatchSize_);
+    if (items.empty())
+        actions_.playback.stop->trigger();
+    else {
+        playItemsPushingToHistory_(std::move(items));
+        QTimer::singleShot(0, this, SLOT(prefetchRandomItems()));
+    }
+}
+
+void PlaylistComponent::prefetchRandomItems()
+{
+    if (randomItemCount() == 0
+            || prefetchedRandomItems_.size() >= prefetchedRandomItemCount) {
+        return;
+    }
+    if (fullShuffle_) {
+        // Prefetched items follow each other in shuffled order.
+        const std::uint64_t after = prefetchedRandomItems_.empty() ?
+                                    shuffleCursor_ :
+                                    shuffleKey(prefetchedRandomItems_.back(),
+                                               shuffleSeed_);
+        for (auto & next : nextShuffledItems(
+                    after, prefetchedRandomItemCount
+                    - prefetchedRandomItems_.size())) {
+            readAheadThread_.add(next.second);
+            prefetchedRandomItems_.push_back(std::move(next.second));
+        }
+        return;
+    }
+    const unsigned recentEntryCount = recentItemCount();
+    // Limit the number of attempts in case there are few distinct candidates.
+    for (std::size_t attempts = 2 * prefetchedRandomItemCount;
+            prefetchedRandomItems_.size() < prefetchedRandomItemCount
+            && attempts > 0; --attempts) {
+        std::string item = chooseRandomItem(recentEntryCount);
+        if (recentEntryCount > 0
+                && std::find(prefetchedRandomItems_.cbegin(),
+                             prefetchedRandomItems_.cend(), item)
+                != prefetchedRandomItems_.cend()) {
+            continue;
+        }
+        readAheadThread_.add(item);
+        prefetchedRandomItems_.push_back(std::move(item));
+    }
+}
+
+void PlaylistComponent::onPrefetchedItemMissing(const QString & item)
+{
+    const std::string path = QtUtilities::qStringToString(item);
+    const auto it = std::find(prefetchedRandomItems_.begin(),
+                              prefetchedRandomItems_.end(), path);
+    if (it != prefetchedRandomItems_.end()) {
+        prefetchedRandomItems_.erase(it);
+# ifdef DEBUG_VENTUROUS_PLAYLIST_COMPONENT
+        std::cout << "Skipped missing random item: " << path << std::endl;
+# endif
+    }
+}
+
 void PlaylistComponent::playbackPlayAll()
 {
-    auto all = itemTree_.getAllItems<CommonTypes::ItemCollection>();
-    if (all.empty())
+    if (itemTree_.itemCount() == 0)
         actions_.playback.stop->trigger();
-    else
-        playItems_(std::move(all));
+    else {
+        playStreamedItems_([this](const CommonTypes::ItemConsumer & consume) {
+            forEachPlayableItem(itemTree_, consume);
+        });
+    }
 }
 
 void PlaylistComponent::onEditModeStateChanged()
@@ -20,6 +20,9 @@
 # define VENTUROUS_PLAYLIST_COMPONENT_HPP
 
 # include "TreeWidget.hpp"
+# include "ItemIndex.hpp"
+# include "WeightedItemChooser.hpp"
+# include "ReadAheadThread.hpp"
 # include "CommonTypes.hpp"
 # include "Preferences.hpp"
 
@@ -28,8 +31,18 @@
 # include <QtGlobal>
 # include <QString>
 # include <QObject>
+# include <QWidget>
+# include <QLineEdit>
+# include <QCheckBox>
 
+# include <cstdint>
+# include <cstddef>
+# include <utility>
 # include <functional>
+# include <random>
+# include <deque>
+# include <unordered_set>
+# include <vector>
 # include <string>
 
 
@@ -58,14 +71,19 @@ public:
 
     /// @param cancelled Is set to true if user has cancelled launching
     /// application (because of error); is set to false otherwise.
-    /// NOTE: mainWindow, actions, inputController and preferences must remain
-    /// valid throughout this PlaylistComponent's lifetime.
+    /// NOTE: mainWindow, actions, inputController, preferences and
+    /// customActionJobs must remain valid throughout this PlaylistComponent's
+    /// lifetime.
     explicit PlaylistComponent(
         QMainWindow & mainWindow, const Actions & actions,
         QtUtilities::Widgets::InputController & inputController,
         const Preferences & preferences,
+        CustomActions::JobScheduler & customActionJobs,
         IsRecentHistoryEntry isRecentHistoryEntry,
+        CommonTypes::ItemProducer historyEntries,
         CommonTypes::PlayItems playItems,
+        CommonTypes::PlayStreamedItems playStreamedItems,
+        CommonTypes::PlayItems playItemsPushingToHistory,
         const std::string & preferencesDir, bool & cancelled);
     /// NOTE: does not block execution.
     ~PlaylistComponent();
@@ -78,15 +96,29 @@ public:
     /// NOTE: does not block execution.
     bool editMode() const { return treeWidget_.editMode(); }
 
-    /// @brief If itemTree_ is not empty, selects random item and starts
-    /// playing it.
+    /// @brief If there are items to choose from, selects random item and
+    /// starts playing it. If random choice is restricted to filtered items,
+    /// only playable items that match the filter and their playable
+    /// descendants are considered.
     /// @return true if playback was started, false otherwise
     bool playRandomItem();
 
+    /// @return Key of the current full shuffle order.
+    /// NOTE: does not block execution.
+    std::uint64_t shuffleSeed() const { return shuffleSeed_; }
+    /// @return Shuffle key of the last item played in full shuffle mode.
+    /// NOTE: does not block execution.
+    std::uint64_t shuffleCursor() const { return shuffleCursor_; }
+
     /// @brief Should be called before normal quit.
     /// @return true if quit is allowed, false if user cancelled it.
     bool quit();
 
+public slots:
+    /// @brief Must be called after history entries change.
+    /// NOTE: does not block execution.
+    void historyChanged();
+
 signals:
     /// @brief Is emitted after playlist edit mode is changed.
     /// WARNING: signal receiver may not block execution.
@@ -94,6 +126,11 @@ signals:
 
 private:
     using FilenameGetter = std::function<QString()>;
+    /// Items with their shuffle keys in ascending key order.
+    using ShuffledItems = std::vector<std::pair<std::uint64_t, std::string>>;
+    /// Ids of itemIndex_ nodes with their shuffle keys in ascending key order.
+    using ShuffleOrder =
+        std::vector<std::pair<std::uint64_t, ItemIndex::NodeId>>;
 
     /// Must be called after switching edit mode.
     /// NOTE: does not block execution.
@@ -119,9 +156,73 @@ private:
     bool ensureAskInEditMode();
     bool ensureAskOutOfEditMode();
 
+    /// @brief Must be called after itemTree_ is changed.
+    /// NOTE: does not block execution.
+    void itemTreeChanged();
+    /// @return true if random items must be chosen among filteredItems().
+    /// NOTE: does not block execution.
+    bool randomFromFiltered() const;
+    /// @brief Builds itemIndex_ if it is not valid.
+    /// NOTE: does not block execution.
+    void ensureValidItemIndex();
+    /// @return Playable items of itemTree_ that match the filter.
+    /// Builds itemIndex_ and filteredItems_ if they are not valid.
+    /// NOTE: does not block execution.
+    const ItemSubset & filteredItems();
+    /// @return Chooser of items of itemTree_ according to randomWeighting_.
+    /// Builds itemIndex_ and weightedItems_ if they are not valid.
+    /// NOTE: does not block execution.
+    const WeightedItemChooser & weightedItems();
+    /// @return Number of items among which random items are chosen.
+    /// NOTE: does not block execution.
+    std::size_t randomItemCount();
+    /// @brief Passes each item among which random items are chosen to consume.
+    /// NOTE: does not block execution.
+    void forEachRandomCandidate(const CommonTypes::ItemConsumer & consume);
+
+    /// @brief Starts a new full shuffle cycle in a new order.
+    /// NOTE: does not block execution.
+    void startShuffleCycle();
+    /// @return All random candidates in shuffled order.
+    /// Builds itemIndex_ and shuffleOrder_ if they are not valid.
+    /// Complexity: O(1) if shuffleOrder_ is valid. Otherwise
+    /// O(number of random candidates * log(number of random candidates)).
+    /// NOTE: does not block execution.
+    const ShuffleOrder & shuffleOrder();
+    /// @return Up to count items that follow key after in shuffled order.
+    /// Complexity: O(log(number of random candidates) + count) if
+    /// shuffleOrder_ is valid.
+    /// NOTE: does not block execution.
+    ShuffledItems nextShuffledItems(std::uint64_t after, std::size_t count);
+    /// @return The item that follows shuffleCursor_ in shuffled order.
+    /// Starts a new cycle if the current one is over.
+    /// NOTE: does not block execution.
+    std::string nextShuffledItem();
+
+    /// @return Number of most recent history entries that must not be chosen
+    /// as the next random item.
+    /// NOTE: does not block execution.
+    unsigned recentItemCount();
+    /// @return Random item path that is not among recentEntryCount most
+    /// recent history entries.
+    /// NOTE: does not block execution.
+    std::string chooseRandomItem(unsigned recentEntryCount);
     /// @return The next, not too recent, random item path to be played.
+    /// Prefers items chosen in advance by prefetchRandomItems().
     /// NOTE: does not block execution.
     std::string getNextRandomItem();
+    /// @return Up to count distinct random items that are not among recent
+    /// history entries. Fewer items are returned only if there are not
+    /// enough random candidates.
+    /// NOTE: does not block execution.
+    CommonTypes::ItemCollection chooseRandomItems(std::size_t count);
+    /// @brief Appends to items up to count random candidates that are neither
+    /// in chosen nor among recentEntryCount most recent history entries.
+    /// Passes over all candidates once.
+    /// NOTE: does not block execution.
+    void sampleRemainingItems(std::size_t count, unsigned recentEntryCount,
+                              const std::unordered_set<std::string> & chosen,
+                              CommonTypes::ItemCollection & items);
 
     /// @brief Backs up current playlist file.
     /// @return true if backup was successful, false otherwise.
@@ -149,8 +250,19 @@ private:
     const Preferences::AddingPatterns & addingPatterns_;
     const AddingItems::Policy & addingPolicy_;
     unsigned skipRecentHistoryItemCount_;
+    bool fullShuffle_;
+    /// Items are played in ascending order of their shuffle keys, which
+    /// depend on item paths and shuffleSeed_. So the order needs no storage
+    /// and is not affected by adding or removing other items.
+    std::uint64_t shuffleSeed_;
+    std::uint64_t shuffleCursor_;
+    Preferences::Playback::RandomWeighting randomWeighting_;
+    unsigned randomBatchSize_;
     IsRecentHistoryEntry isRecentHistoryEntry_;
+    const CommonTypes::ItemProducer historyEntries_;
     const CommonTypes::PlayItems playItems_;
+    const CommonTypes::PlayStreamedItems playStreamedItems_;
+    const CommonTypes::PlayItems playItemsPushingToHistory_;
     const std::string itemsFilename_;
     const QString qItemsFilename_;
     const QString qBackupItemsFilename_;
@@ -160,12 +272,71 @@ private:
     ItemTree::Tree itemTree_;
     std::unique_ptr<ItemTree::Tree> temporaryTree_;
     ItemTree::RandomItemChooser randomItemChooser_;
-
+    /// Random items chosen in advance, which are played next.
+    std::deque<std::string> prefetchedRandomItems_;
+    /// Reads ahead prefetchedRandomItems_ and reports missing ones.
+    ReadAheadThread readAheadThread_;
+    std::mt19937 randomEngine_ { std::random_device {}() };
+    /// Is true if randomEngine_ was seeded from VENTUROUS_RANDOM_SEED
+    /// environment variable. In this case all random choices are made by
+    /// randomEngine_, so they are reproducible.
+    bool fixedRandomSeed_ = false;
+    /// Statistics that are printed on quit if
+    /// DEBUG_VENTUROUS_PLAYLIST_COMPONENT is defined.
+    /// Number of items chosen by chooseRandomItem().
+    std::uint64_t randomPickCount_ = 0;
+    /// Number of chosen random items that were discarded because they were
+    /// among recent history entries. Items discarded as duplicates of other
+    /// prefetched or batch items are not counted.
+    std::uint64_t rejectedRandomPickCount_ = 0;
+
+    /// Index of itemTree_. Is valid only if itemIndexValid_.
+    ItemIndex itemIndex_;
+    bool itemIndexValid_ = false;
+    /// Is valid only if filteredItemsValid_.
+    ItemSubset filteredItems_;
+    bool filteredItemsValid_ = false;
+    /// Is valid only if weightedItemsValid_. Is used only if
+    /// randomWeighting_ is not uniform.
+    WeightedItemChooser weightedItems_;
+    bool weightedItemsValid_ = false;
+    /// Is valid only if shuffleOrderValid_. Contains filteredItems_ if
+    /// shuffleOrderFiltered_, all playable items of itemIndex_ otherwise.
+    /// Is rebuilt only when shuffleSeed_ or random candidates change, so
+    /// choosing the next shuffled item does not hash the whole playlist.
+    ShuffleOrder shuffleOrder_;
+    bool shuffleOrderValid_ = false;
+    bool shuffleOrderFiltered_ = false;
+    /// Is true if history has changed since weightedItems_ was updated.
+    bool weightedItemsHistoryOutdated_ = false;
+
+    /// NOTE: centralWidget_ and its children must be declared before
+    /// treeWidget_ so that child widgets are destroyed before their parent.
+    QWidget centralWidget_;
+    QLineEdit filterEdit_;
+    QCheckBox randomFromFilteredCheckBox_;
     TreeWidget treeWidget_;
 
 private slots:
+    /// @brief Chooses several next random items in advance and passes them
+    /// to readAheadThread_, which asks OS to read ahead their beginning so
+    /// that the next random item starts playing without delay.
+    /// NOTE: does not block execution.
+    void prefetchRandomItems();
+    /// @brief Removes missing item from prefetchedRandomItems_.
+    /// NOTE: does not block execution.
+    void onPrefetchedItemMissing(const QString & item);
+
+    void onFind();
+    void onFilterChanged(const QString & filter);
+    /// NOTE: does not block execution.
+    void onRandomFromFilteredToggled();
+    /// @brief Starts playing all filtered items.
+    void playFilteredItems();
+
     void playbackNextRandom();
     void playbackPlayAll();
+    void playbackPlayRandomBatch();
 
     void onEditModeStateChanged();
     void applyChanges();
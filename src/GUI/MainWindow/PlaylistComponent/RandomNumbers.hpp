@@ -0,0 +1,54 @@
+/*
+ This file is part of Venturous.
+ Copyright (C) 2026 Igor Kushnir <igorkuo AT Google mail>
+
+ Venturous is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Venturous is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ Venturous.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef VENTUROUS_RANDOM_NUMBERS_HPP
+# define VENTUROUS_RANDOM_NUMBERS_HPP
+
+# include <cstdint>
+# include <random>
+
+
+/// Maps output of std::mt19937 to random numbers in the same way on every
+/// platform. std::mt19937 itself produces identical sequences everywhere, but
+/// standard distributions are implementation-defined, so they would break
+/// reproducibility of random choices made from a fixed seed.
+namespace RandomNumbers
+{
+/// @return Uniformly distributed random number in [0, count).
+/// NOTE: count must be positive.
+inline std::uint32_t index(std::mt19937 & engine, const std::uint32_t count)
+{
+    // Lemire's multiply-and-shift method with rejection of the biased part.
+    std::uint64_t product = std::uint64_t(engine()) * count;
+    if (std::uint32_t(product) < count) {
+        const std::uint32_t threshold = std::uint32_t(-count) % count;
+        while (std::uint32_t(product) < threshold)
+            product = std::uint64_t(engine()) * count;
+    }
+    return std::uint32_t(product >> 32);
+}
+
+/// @return Uniformly distributed random number in [0, 1).
+inline double fraction(std::mt19937 & engine)
+{
+    return engine() * (1.0 / 4294967296.0);
+}
+
+}
+
+# endif // VENTUROUS_RANDOM_NUMBERS_HPP
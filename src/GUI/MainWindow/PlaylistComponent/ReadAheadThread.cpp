@@ -0,0 +1,126 @@
+/*
+ This file is part of Venturous.
+ Copyright (C) 2026 Igor Kushnir <igorkuo AT Google mail>
+
+ Venturous is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Venturous is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ Venturous.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+# include "ReadAheadThread.hpp"
+
+# include <QtCoreUtilities/String.hpp>
+
+# include <QtGlobal>
+# include <QString>
+# include <QStringList>
+# include <QFile>
+# include <QFileInfo>
+# include <QDir>
+# include <QMutexLocker>
+
+# ifdef Q_OS_LINUX
+# include <fcntl.h>
+# include <unistd.h>
+# endif
+
+# include <utility>
+# include <algorithm>
+# include <string>
+
+
+namespace
+{
+/// Maximum number of bytes at the beginning of each file that is read ahead.
+constexpr long prefetchedFileSize = 512 * 1024;
+/// Maximum number of files read ahead in each prefetched directory.
+constexpr int maxPrefetchedDirectoryFileCount = 2;
+
+/// @brief Asks OS to asynchronously read the beginning of file into page cache.
+/// Does nothing if this is not supported on current platform.
+void readAhead(const QString & filename)
+{
+# ifdef Q_OS_LINUX
+    const int fd = ::open(QFile::encodeName(filename).constData(),
+                          O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return;
+    ::posix_fadvise(fd, 0, prefetchedFileSize, POSIX_FADV_WILLNEED);
+    ::close(fd);
+# else
+    static_cast<void>(filename);
+# endif
+}
+
+/// @brief Checks that item still exists and reads ahead its first bytes
+/// (first files if item is a directory).
+/// @return true if item exists.
+bool prepareForPlaying(const QString & path)
+{
+    const QFileInfo info(path);
+    if (info.isFile()) {
+        readAhead(path);
+        return true;
+    }
+    if (! info.isDir())
+        return false;
+    const QStringList files = QDir(path).entryList(QDir::Files, QDir::Name);
+    const int count = std::min(files.size(), maxPrefetchedDirectoryFileCount);
+    for (int i = 0; i < count; ++i)
+        readAhead(path + '/' + files[i]);
+    return true;
+}
+
+} // END unnamed namespace
+
+
+ReadAheadThread::~ReadAheadThread()
+{
+    {
+        const QMutexLocker locker(& mutex_);
+        stopping_ = true;
+        condition_.wakeAll();
+    }
+    wait();
+}
+
+void ReadAheadThread::add(std::string item)
+{
+    {
+        const QMutexLocker locker(& mutex_);
+        queue_.push_back(std::move(item));
+        condition_.wakeAll();
+    }
+    if (! isRunning())
+        start(QThread::LowPriority);
+}
+
+
+void ReadAheadThread::run()
+{
+    QMutexLocker locker(& mutex_);
+    while (true) {
+        while (! stopping_ && queue_.empty())
+            condition_.wait(& mutex_);
+        if (stopping_)
+            return;
+        const QString path = QtUtilities::toQString(queue_.front());
+        queue_.pop_front();
+        locker.unlock();
+
+        if (! prepareForPlaying(path))
+            emit itemMissing(path);
+
+        locker.relock();
+    }
+}
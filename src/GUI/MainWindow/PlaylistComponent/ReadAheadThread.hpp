@@ -0,0 +1,64 @@
+/*
+ This file is part of Venturous.
+ Copyright (C) 2026 Igor Kushnir <igorkuo AT Google mail>
+
+ Venturous is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Venturous is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ Venturous.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+# ifndef VENTUROUS_READ_AHEAD_THREAD_HPP
+# define VENTUROUS_READ_AHEAD_THREAD_HPP
+
+# include <QString>
+# include <QMutex>
+# include <QWaitCondition>
+# include <QThread>
+
+# include <deque>
+# include <string>
+
+
+/// Checks that items exist and asks OS to read ahead their first bytes
+/// (first files if item is a directory) in a background thread, so that
+/// slow media do not stall GUI.
+class ReadAheadThread : public QThread
+{
+    Q_OBJECT
+public:
+    explicit ReadAheadThread(QObject * parent = nullptr) : QThread(parent) {}
+    /// @brief Stops the thread. Items that were not processed yet are
+    /// discarded.
+    ~ReadAheadThread() override;
+
+    /// @brief Schedules checking item and reading it ahead.
+    /// NOTE: does not block execution.
+    void add(std::string item);
+
+signals:
+    /// @brief Is emitted from background thread for each scheduled item that
+    /// does not exist.
+    void itemMissing(const QString & item);
+
+private:
+    void run() override;
+
+
+    /// Protects all fields that follow.
+    QMutex mutex_;
+    QWaitCondition condition_;
+    std::deque<std::string> queue_;
+    bool stopping_ = false;
+};
+
+# endif // VENTUROUS_READ_AHEAD_THREAD_HPP
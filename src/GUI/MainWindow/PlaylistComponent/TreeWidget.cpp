@@ -26,10 +26,11 @@
 
 # include "TreeWidget.hpp"
 
+# include "ItemIndex.hpp"
 # include "CommonTypes.hpp"
 # include "CustomActions.hpp"
 
-# include <VenturousCore/ItemTree-inl.hpp>
+# include <VenturousCore/ItemTree.hpp>
 
 # include <QtCoreUtilities/String.hpp>
 
@@ -37,13 +38,22 @@
 # include <QList>
 # include <QString>
 # include <QStringList>
+# include <QFileInfo>
 # include <QColor>
 # include <QPalette>
+# include <QEvent>
+# include <QModelIndex>
+# include <QAbstractItemModel>
+# include <QStyleOptionViewItem>
+# include <QStyledItemDelegate>
 # include <QTreeWidgetItem>
 # include <QHeaderView>
+# include <QScrollBar>
+# include <QResizeEvent>
 # include <QKeyEvent>
 # include <QContextMenuEvent>
 
+# include <cstddef>
 # include <cassert>
 # include <utility>
 # include <algorithm>
@@ -54,6 +64,79 @@
 
 namespace
 {
+/// If there are more matches, filtering does not unfold their ancestors.
+constexpr std::size_t maxUnfoldedMatchCount = 1000;
+
+/// Marks of nodes used during filtering.
+enum : unsigned char { matchMark = 1, ancestorMark = 2 };
+
+/// QTreeWidgetItem that stores index of its node among sibling nodes.
+/// This allows to find the node that corresponds to an item without
+/// searching for the item among its siblings or comparing names.
+class Item : public QTreeWidgetItem
+{
+public:
+    template <class Parent>
+    explicit Item(Parent * parent, const QString & text,
+                  const std::size_t nodeIndex)
+        : QTreeWidgetItem(parent, QStringList { text }, UserType),
+          nodeIndex(nodeIndex) {}
+
+    std::size_t nodeIndex;
+    /// Is equal to TreeWidget::unfoldGeneration_ if this item was already
+    /// considered for auto-unfolding.
+    unsigned unfoldGeneration = 0;
+};
+
+/// NOTE: each item in TreeWidget is an Item.
+inline std::size_t & nodeIndex(QTreeWidgetItem * item)
+{
+    return static_cast<Item *>(item)->nodeIndex;
+}
+
+inline std::size_t nodeIndex(const QTreeWidgetItem * item)
+{
+    return static_cast<const Item *>(item)->nodeIndex;
+}
+
+inline unsigned & unfoldGeneration(QTreeWidgetItem * item)
+{
+    return static_cast<Item *>(item)->unfoldGeneration;
+}
+
+/// @return Number of item's ancestors.
+int depth(const QTreeWidgetItem * item)
+{
+    int result = 0;
+    while ((item = item->parent()) != nullptr)
+        ++result;
+    return result;
+}
+
+/// @return Node that corresponds to item in tree or nullptr if there is no
+/// such node in tree.
+/// Complexity: O(item depth).
+ItemTree::Node * findNode(ItemTree::Tree & tree, const QTreeWidgetItem * item)
+{
+    // Node indices from item up to its top-level ancestor.
+    std::vector<std::size_t> indices;
+    do {
+        indices.push_back(nodeIndex(item));
+        item = item->parent();
+    }
+    while (item != nullptr);
+
+    std::vector<ItemTree::Node> * nodes = & tree.topLevelNodes();
+    for (auto it = indices.crbegin(); ; ) {
+        if (* it >= nodes->size())
+            return nullptr;
+        ItemTree::Node & node = (* nodes)[* it];
+        if (++it == indices.crend())
+            return & node;
+        nodes = & node.children();
+    }
+}
+
 inline bool isChecked(const QTreeWidgetItem * item)
 {
     return item->checkState(0) == Qt::Checked;
@@ -91,28 +174,48 @@ void setTooltip(const QTreeWidget *, QTreeWidgetItem * item)
     item->setToolTip(0, "");
 }
 
+constexpr Qt::ItemFlags itemFlags() noexcept {
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsUserCheckable;
+}
+
 /// @brief Creates structure that matches node's structure
 /// and places it under parent as a root.
+/// @param nodeIndex Index of node among its siblings.
 template <class Parent>
 void createTreeWidgetItem(
-    Parent * parent, const ItemTree::Node & node)
+    Parent * parent, const ItemTree::Node & node, const std::size_t nodeIndex)
 {
-    QTreeWidgetItem * const item = new QTreeWidgetItem(
-        parent, { QtUtilities::toQString(node.name()) });
+    QTreeWidgetItem * const item = new Item(
+        parent, QtUtilities::toQString(node.name()), nodeIndex);
+    item->setFlags(itemFlags());
     setTooltip(parent, item);
     setChecked(item, node.isPlayable());
 
+    std::size_t childIndex = 0;
     for (const ItemTree::Node & child : node.children())
-        createTreeWidgetItem(item, child);
+        createTreeWidgetItem(item, child, childIndex++);
 }
 
-constexpr Qt::ItemFlags readOnlyFlags() noexcept {
-    return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
-}
+/// Item delegate that lets user toggle check boxes only in edit mode.
+/// Thus editability is a property of the view rather than of each item, and
+/// switching edit mode does not touch items.
+class ItemDelegate : public QStyledItemDelegate
+{
+public:
+    /// NOTE: editMode must remain valid throughout this delegate's lifetime.
+    explicit ItemDelegate(const bool & editMode, QObject * parent)
+        : QStyledItemDelegate(parent), editMode_(editMode) {}
+
+    bool editorEvent(QEvent * event, QAbstractItemModel * model,
+                     const QStyleOptionViewItem & option,
+                     const QModelIndex & index) override {
+        return editMode_ &&
+               QStyledItemDelegate::editorEvent(event, model, option, index);
+    }
 
-constexpr Qt::ItemFlags editableFlags() noexcept {
-    return readOnlyFlags() | Qt::ItemIsUserCheckable;
-}
+private:
+    const bool & editMode_;
+};
 
 QPalette getPlaylistPalette(QPalette currentPalette, bool editMode)
 {
@@ -126,32 +229,6 @@ QPalette getPlaylistPalette(QPalette currentPalette, bool editMode)
     return currentPalette;
 }
 
-/// @brief Sets flags for specified item and all its descendants.
-void recursivelySetFlags(QTreeWidgetItem * item, Qt::ItemFlags flags)
-{
-    item->setFlags(flags);
-    for (int i = item->childCount() - 1; i >= 0; --i)
-        recursivelySetFlags(item->child(i), flags);
-}
-
-/// @brief Removes all selected descendants of item and corresponding
-/// descendants of node.
-void removeSelectedItems(QTreeWidgetItem * item, ItemTree::Node & node)
-{
-    std::vector<ItemTree::Node> & children = node.children();
-    assert(int(children.size()) == item->childCount());
-
-    for (int i = item->childCount() - 1; i >= 0; --i) {
-        QTreeWidgetItem * child = item->child(i);
-        if (child->isSelected()) {
-            children.erase(children.begin() + i);
-            delete child;
-        }
-        else
-            removeSelectedItems(child, children[std::size_t(i)]);
-    }
-}
-
 typedef std::deque<QString> PlayablePaths;
 /// @brief Appends absolute paths of item's playable descendants
 /// (including item) that are under selection to playablePaths.
@@ -188,10 +265,12 @@ TreeWidget::Error::~Error() noexcept = default;
 TreeWidget::TreeWidget(const ItemTree::Tree & itemTree,
                        const std::unique_ptr<ItemTree::Tree> & temporaryTree,
                        const CustomActions::Actions & customActions,
+                       CustomActions::JobScheduler & customActionJobs,
                        CommonTypes::PlayItems playItems,
                        QWidget * const parent)
     : QTreeWidget(parent), itemTree_(itemTree), temporaryTree_(temporaryTree),
-      customActions_(customActions), playItems_(std::move(playItems)),
+      customActions_(customActions), customActionJobs_(customActionJobs),
+      playItems_(std::move(playItems)),
       tooltipShower_(this)
 {
     setColumnCount(1);
@@ -206,11 +285,16 @@ TreeWidget::TreeWidget(const ItemTree::Tree & itemTree,
     header()->setStretchLastSection(false);
     setUniformRowHeights(true);
     setSelectionMode(QAbstractItemView::ExtendedSelection);
+    setItemDelegate(new ItemDelegate(editMode_, this));
 
     connect(this, SIGNAL(itemActivated(QTreeWidgetItem *, int)),
             SLOT(onUiItemActivated(QTreeWidgetItem *)));
     connect(this, SIGNAL(itemChanged(QTreeWidgetItem *, int)),
             SLOT(onUiItemChanged(QTreeWidgetItem *)));
+    connect(this, SIGNAL(itemExpanded(QTreeWidgetItem *)),
+            SLOT(unfoldVisibleItems()));
+    connect(verticalScrollBar(), SIGNAL(valueChanged(int)),
+            SLOT(unfoldVisibleItems()));
 
     updateTree();
 }
@@ -241,42 +325,112 @@ void TreeWidget::setAutoUnfoldedLevels(const int autoUnfoldedLevels)
     }
 }
 
+void TreeWidget::setFilter(const QString & filter)
+{
+    if (filter == filter_)
+        return;
+    filter_ = filter;
+    applyFilter();
+}
+
 
 void TreeWidget::updateTree(const ItemTree::Tree & itemTree)
 {
     const bool blocked = blockSignals(true);
+    hiddenItems_.clear();
+    itemIndexValid_ = false;
+    // Items could have been rescanned, so their types could have changed.
+    leafIsDirectory_.clear();
     clear();
+    std::size_t index = 0;
     for (const ItemTree::Node & topLevelNode : itemTree.topLevelNodes())
-        createTreeWidgetItem(this, topLevelNode);
+        createTreeWidgetItem(this, topLevelNode, index++);
     setUiEditMode();
     autoUnfold();
+    if (! filter_.isEmpty())
+        applyFilter();
     blockSignals(blocked);
 }
 
 void TreeWidget::setUiEditMode()
 {
-    const bool blocked = blockSignals(true);
-    const bool visible = isVisible();
-    if (visible)
-        hide(); // Dramatically improves performance for large tree.
-
+    // Items are not affected: ItemDelegate checks editMode_ directly.
     setPalette(getPlaylistPalette(palette(), editMode_));
-    const Qt::ItemFlags flags = editMode_ ? editableFlags() : readOnlyFlags();
-    for (int i = topLevelItemCount() - 1; i >= 0; --i)
-        recursivelySetFlags(topLevelItem(i), flags);
-
-    if (visible)
-        show();
     setFocus();
-    blockSignals(blocked);
 }
 
 void TreeWidget::autoUnfold()
 {
-    if (autoUnfoldedLevels_ == 0)
-        collapseAll();
-    else
-        expandToDepth(autoUnfoldedLevels_ - 1);
+    collapseAll();
+    ++unfoldGeneration_;
+    unfoldVisibleItems();
+}
+
+void TreeWidget::resizeEvent(QResizeEvent * const event)
+{
+    QTreeWidget::resizeEvent(event);
+    unfoldVisibleItems();
+}
+
+void TreeWidget::applyFilter()
+{
+    showHiddenItems();
+    if (filter_.isEmpty())
+        return;
+    if (! itemIndexValid_) {
+        itemIndex_.build(editMode_ ? * temporaryTree_ : itemTree_);
+        itemIndexValid_ = true;
+    }
+    const ItemIndex::NodeIds matches = itemIndex_.find(filter_);
+# ifdef DEBUG_VENTUROUS_TREE_WIDGET
+    std::cout << "TreeWidget: " << matches.size() << " items match filter."
+              << std::endl;
+# endif
+
+    std::vector<unsigned char> marks(itemIndex_.nodeCount(), 0);
+    for (const ItemIndex::NodeId id : matches) {
+        marks[id] |= matchMark;
+        for (ItemIndex::NodeId parent = itemIndex_.parent(id);
+                parent != ItemIndex::noNode && ! (marks[parent] & ancestorMark);
+                parent = itemIndex_.parent(parent)) {
+            marks[parent] |= ancestorMark;
+        }
+    }
+    // Hidden items must not be affected by actions on selection.
+    clearSelection();
+    filterChildren(invisibleRootItem(), 0, itemIndex_.nodeCount(), marks,
+                   matches.size() <= maxUnfoldedMatchCount);
+}
+
+void TreeWidget::filterChildren(
+    QTreeWidgetItem * const parent, const ItemIndex::NodeId first,
+    const ItemIndex::NodeId end, const std::vector<unsigned char> & marks,
+    const bool unfold)
+{
+    int row = 0;
+    for (ItemIndex::NodeId id = first; id < end;
+            id = itemIndex_.subtreeEnd(id), ++row) {
+        QTreeWidgetItem * const item = parent->child(row);
+        if (marks[id] == 0) {
+            item->setHidden(true);
+            hiddenItems_.push_back(item);
+        }
+        else if (marks[id] == ancestorMark) {
+            // The whole subtree of a matching item stays visible, so only
+            // items that do not match themselves are recursed into.
+            if (unfold)
+                item->setExpanded(true);
+            filterChildren(item, id + 1, itemIndex_.subtreeEnd(id), marks,
+                           unfold);
+        }
+    }
+}
+
+void TreeWidget::showHiddenItems()
+{
+    for (QTreeWidgetItem * const item : hiddenItems_)
+        item->setHidden(false);
+    hiddenItems_.clear();
 }
 
 void TreeWidget::keyPressEvent(QKeyEvent * const event)
@@ -323,17 +477,56 @@ void TreeWidget::onDelete()
     printMessageAndSelectedItemsSize("Delete pressed", selectedItems().size());
 # endif
     assertValidTemporaryTree();
-    std::vector<ItemTree::Node> & nodes = temporaryTree_->topLevelNodes();
-    assert(int(nodes.size()) == topLevelItemCount());
-
-    for (int i = topLevelItemCount() - 1; i >= 0; --i) {
-        QTreeWidgetItem * item = topLevelItem(i);
-        if (item->isSelected()) {
-            nodes.erase(nodes.begin() + i);
-            delete item;
+    // Hidden items can be removed along with their selected ancestors.
+    showHiddenItems();
+    removeSelectedItems(invisibleRootItem(), temporaryTree_->topLevelNodes());
+    itemIndexValid_ = false;
+    if (! filter_.isEmpty())
+        applyFilter();
+}
+
+void TreeWidget::removeSelectedItems(QTreeWidgetItem * const parent,
+                                     std::vector<ItemTree::Node> & nodes)
+{
+    const int nChildren = parent->childCount();
+    assert(int(nodes.size()) == nChildren);
+
+    // Compact nodes in a single pass, recursing into the remaining ones.
+    std::vector<bool> selected(std::size_t(nChildren), false);
+    std::size_t nKept = 0;
+    for (int i = 0; i < nChildren; ++i) {
+        const std::size_t index = std::size_t(i);
+        QTreeWidgetItem * const child = parent->child(i);
+        if (child->isSelected())
+            selected[index] = true;
+        else {
+            removeSelectedItems(child, nodes[index].children());
+            if (nKept != index) {
+                nodes[nKept] = std::move(nodes[index]);
+                nodeIndex(child) = nKept;
+            }
+            ++nKept;
+        }
+    }
+    if (nKept == nodes.size())
+        return;
+    nodes.erase(nodes.begin() + std::ptrdiff_t(nKept), nodes.end());
+
+    // Remove each contiguous range of selected items at once. Going backwards
+    // keeps row numbers of not yet processed items valid.
+    const QModelIndex parentIndex = parent == invisibleRootItem() ?
+                                    QModelIndex() : indexFromItem(parent);
+    for (int last = nChildren - 1; last >= 0; --last) {
+        if (! selected[std::size_t(last)])
+            continue;
+        int first = last;
+        while (first > 0 && selected[std::size_t(first - 1)])
+            --first;
+        if (! model()->removeRows(first, last - first + 1, parentIndex)) {
+            for (int i = last; i >= first; --i)
+                delete parent->child(i);
         }
-        else
-            removeSelectedItems(item, nodes[std::size_t(i)]);
+        last = first;
     }
 }
 
@@ -354,6 +547,17 @@ void TreeWidget::onEnter()
     }
 }
 
+bool TreeWidget::isDirectory(const QTreeWidgetItem * const item)
+{
+    if (item->childCount() > 0)
+        return true;
+    const QString path = itemPath(item);
+    auto it = leafIsDirectory_.constFind(path);
+    if (it == leafIsDirectory_.constEnd())
+        it = leafIsDirectory_.insert(path, QFileInfo(path).isDir());
+    return it.value();
+}
+
 void TreeWidget::contextMenuEvent(QContextMenuEvent * const event)
 {
 # ifdef DEBUG_VENTUROUS_TREE_WIDGET
@@ -363,29 +567,30 @@ void TreeWidget::contextMenuEvent(QContextMenuEvent * const event)
     const QPoint position = event->globalPos();
     QString commonPrefix;
     QStringList itemNames;
-    {
-        const auto selected = selectedItems();
-        if (! selected.empty()) {
-            const QTreeWidgetItem * const parent = selected.front()->parent();
-            for (int i = 1; i < selected.size(); ++i) {
-                if (selected[i]->parent() != parent) {
-                    tooltipShower_.show(
-                        position,
-                        tr("Custom actions are enabled only if all "
-                           "selected items are siblings (share the same "
-                           "parent tree node)."));
-                    return;
-                }
+    const auto selected = selectedItems();
+    if (! selected.empty()) {
+        const QTreeWidgetItem * const parent = selected.front()->parent();
+        for (int i = 1; i < selected.size(); ++i) {
+            if (selected[i]->parent() != parent) {
+                tooltipShower_.show(
+                    position,
+                    tr("Custom actions are enabled only if all "
+                       "selected items are siblings (share the same "
+                       "parent tree node)."));
+                return;
             }
-            commonPrefix = itemTooltip(selected.front());
-            itemNames.reserve(selected.size());
-            for (const QTreeWidgetItem * item : selected)
-                itemNames << itemText(item);
         }
+        commonPrefix = itemTooltip(selected.front());
+        itemNames.reserve(selected.size());
+        for (const QTreeWidgetItem * item : selected)
+            itemNames << itemText(item);
     }
+    const auto isSelectedDirectory = [&](int itemIndex) {
+        return isDirectory(selected[itemIndex]);
+    };
     CustomActions::showMenu(
         customActions_, std::move(commonPrefix), std::move(itemNames),
-        position, tooltipShower_);
+        position, tooltipShower_, customActionJobs_, isSelectedDirectory);
 }
 
 void TreeWidget::applyToSelectedItems(ItemUser itemUser)
@@ -398,6 +603,29 @@ void TreeWidget::applyToSelectedItems(ItemUser itemUser)
 }
 
 
+void TreeWidget::unfoldVisibleItems()
+{
+    if (autoUnfoldedLevels_ == 0 || unfolding_)
+        return;
+    unfolding_ = true;
+    const int viewportHeight = viewport()->height();
+    for (QTreeWidgetItem * item = itemAt(0, 0);
+            item != nullptr && visualItemRect(item).top() < viewportHeight;
+            item = itemBelow(item)) {
+        unsigned & generation = unfoldGeneration(item);
+        if (generation == unfoldGeneration_)
+            continue;
+        generation = unfoldGeneration_;
+        // Expanding item makes its children visible right below it, so they
+        // are considered during the following iterations.
+        if (! item->isExpanded() && item->childCount() > 0
+                && depth(item) < autoUnfoldedLevels_) {
+            item->setExpanded(true);
+        }
+    }
+    unfolding_ = false;
+}
+
 void TreeWidget::onUiItemActivated(QTreeWidgetItem * const item)
 {
     if (editMode_ || ! isChecked(item))
@@ -415,16 +643,8 @@ void TreeWidget::onUiItemChanged(QTreeWidgetItem * item)
 # endif
 
     const bool checked = isChecked(item);
-    std::deque<std::string> path;
-    do {
-        path.emplace_front(QtUtilities::qStringToString(itemText(item)));
-        item = item->parent();
-    }
-    while (item != nullptr);
-
     assertValidTemporaryTree();
-    ItemTree::Node * const node = temporaryTree_->descendant(
-                                      path.cbegin(), path.cend());
+    ItemTree::Node * const node = findNode(* temporaryTree_, item);
     if (node == nullptr)
         throw Error("could not find specified item in temporaryTree_.");
     if (checked == node->isPlayable()) {
@@ -19,6 +19,7 @@
 # ifndef VENTUROUS_TREE_WIDGET_HPP
 # define VENTUROUS_TREE_WIDGET_HPP
 
+# include "ItemIndex.hpp"
 # include "CommonTypes.hpp"
 # include "CustomActions.hpp"
 
@@ -27,9 +28,12 @@
 # include <CommonUtilities/CopyAndMoveSemantics.hpp>
 
 # include <QtGlobal>
+# include <QString>
+# include <QHash>
 # include <QTreeWidget>
 
 # include <functional>
+# include <vector>
 # include <string>
 # include <stdexcept>
 # include <memory>
@@ -37,6 +41,7 @@
 
 namespace ItemTree
 {
+class Node;
 class Tree;
 }
 QT_FORWARD_DECLARE_CLASS(QTreeWidgetItem)
@@ -53,11 +58,12 @@ public:
         ~Error() noexcept override;
     };
 
-    /// NOTE: itemTree, temporaryTree and customActions must remain valid
-    /// throughout this TreeWidget's lifetime.
+    /// NOTE: itemTree, temporaryTree, customActions and customActionJobs
+    /// must remain valid throughout this TreeWidget's lifetime.
     explicit TreeWidget(const ItemTree::Tree & itemTree,
                         const std::unique_ptr<ItemTree::Tree> & temporaryTree,
                         const CustomActions::Actions & customActions,
+                        CustomActions::JobScheduler & customActionJobs,
                         CommonTypes::PlayItems playItems,
                         QWidget * parent = nullptr);
 
@@ -86,6 +92,16 @@ public:
 
     int getAutoUnfoldedLevels() const { return autoUnfoldedLevels_; }
 
+    /// @brief Shows only items whose names contain filter (ignoring case),
+    /// their ancestors and descendants. Ancestors of matching items are
+    /// unfolded unless there are too many matches. Selection is cleared.
+    /// Only visibility of the affected items is changed: the tree is not
+    /// rebuilt. Index of items is built on first use after each updateTree().
+    /// @param filter If empty, all items are shown.
+    void setFilter(const QString & filter);
+
+    const QString & filter() const { return filter_; }
+
     void assertValidTemporaryTree() const {
         if (! temporaryTree_)
             throw Error("valid temporaryTree_ expected, nullptr found.");
@@ -97,18 +113,51 @@ private:
     /// @brief Updates visual representation to match itemTree.
     void updateTree(const ItemTree::Tree & itemTree);
 
-    /// @brief Sets appropriate options for QTreeWidget and QTreeWidgetItems
-    /// based on editMode_.
+    /// @brief Sets appropriate options for QTreeWidget based on editMode_.
+    /// Complexity: O(1).
     void setUiEditMode();
 
-    /// @brief Unfolds or folds items, depending on autoUnfoldedLevels_.
+    /// @brief Folds all items and restarts lazy auto-unfolding.
+    /// Only items that become visible (on scrolling, resizing or expanding
+    /// their parents) are unfolded, depending on autoUnfoldedLevels_. So the
+    /// cost does not depend on the tree size.
     void autoUnfold();
 
+    void resizeEvent(QResizeEvent *) override;
+
+    /// @brief Hides items that do not match filter_.
+    void applyFilter();
+    /// @brief Hides children of parent, which have ids in [first, end), that
+    /// are not marked; recurses into those that are ancestors of matches but
+    /// do not match themselves.
+    /// @param unfold If true, ancestors of matches that do not match
+    /// themselves are expanded.
+    void filterChildren(QTreeWidgetItem * parent, ItemIndex::NodeId first,
+                        ItemIndex::NodeId end,
+                        const std::vector<unsigned char> & marks, bool unfold);
+    /// @brief Shows all items hidden by applyFilter().
+    void showHiddenItems();
+
     void keyPressEvent(QKeyEvent *) override;
 
     void onDelete();
+    /// @brief Removes all selected descendants of parent and corresponding
+    /// descendants from nodes - children of the node that matches parent.
+    /// Works in linear time. Contiguous ranges of selected siblings are
+    /// removed from the view in one step each. Node indices stored in
+    /// remaining items are updated.
+    void removeSelectedItems(QTreeWidgetItem * parent,
+                             std::vector<ItemTree::Node> & nodes);
     void onEnter();
 
+    /// @return true if item represents a directory.
+    /// Items with children are directories. Types of leaves (files or
+    /// directories with media files) are queried from file system once and
+    /// then cached until the tree is updated.
+    /// NOTE: ItemTree::Node stores only name, playability and children, so
+    /// the tree data cannot tell a file from a childless directory.
+    bool isDirectory(const QTreeWidgetItem * item);
+
     void contextMenuEvent(QContextMenuEvent *) override;
 
     void applyToSelectedItems(ItemUser f);
@@ -117,14 +166,32 @@ private:
     const ItemTree::Tree & itemTree_;
     const std::unique_ptr<ItemTree::Tree> & temporaryTree_;
     const CustomActions::Actions & customActions_;
+    CustomActions::JobScheduler & customActionJobs_;
     const CommonTypes::PlayItems playItems_;
 
     bool editMode_ = false;
     int autoUnfoldedLevels_ = 9;
+    /// Is incremented by autoUnfold(). Items that store a different value
+    /// have not yet been considered for auto-unfolding.
+    unsigned unfoldGeneration_ = 0;
+    /// Prevents reentering unfoldVisibleItems() when it expands items.
+    bool unfolding_ = false;
+
+    QString filter_;
+    /// Index of the currently shown tree. Is valid only if itemIndexValid_.
+    ItemIndex itemIndex_;
+    bool itemIndexValid_ = false;
+    std::vector<QTreeWidgetItem *> hiddenItems_;
+    /// Maps absolute paths of leaf items to their isDirectory() values.
+    QHash<QString, bool> leafIsDirectory_;
 
     QtUtilities::Widgets::TooltipShower tooltipShower_;
 
 private slots:
+    /// @brief Unfolds visible items that have not yet been considered for
+    /// auto-unfolding if their depth is less than autoUnfoldedLevels_.
+    void unfoldVisibleItems();
+
     void onUiItemActivated(QTreeWidgetItem * item);
     void onUiItemChanged(QTreeWidgetItem * item);
 };
@@ -0,0 +1,126 @@
+/*
+ This file is part of Venturous.
+ Copyright (C) 2026 Igor Kushnir <igorkuo AT Google mail>
+
+ Venturous is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Venturous is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ Venturous.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# include "WeightedItemChooser.hpp"
+
+# include "FenwickTree.hpp"
+# include "ItemIndex.hpp"
+# include "CommonTypes.hpp"
+# include "RandomNumbers.hpp"
+
+# include <cstddef>
+# include <random>
+# include <utility>
+# include <vector>
+# include <string>
+
+
+void WeightedItemChooser::build(
+    const ItemIndex & index, const Weighting weighting,
+    const CommonTypes::ItemProducer & historyEntries)
+{
+    index_ = & index;
+    weighting_ = weighting;
+    ranks_.clear();
+    playCounts_.clear();
+
+    const ItemIndex::NodeId nodeCount = index.nodeCount();
+    std::vector<double> weights;
+    weights.reserve(index.playableCount(0, nodeCount));
+    switch (weighting) {
+        case Weighting::uniform:
+            weights.assign(index.playableCount(0, nodeCount), 1.0);
+            break;
+        case Weighting::topLevelEntries:
+            buildTopLevelEntryWeights(weights);
+            break;
+        case Weighting::historyPlayCount:
+        {
+            ItemIndex::NodeId rank = 0;
+            for (ItemIndex::NodeId id = 0; id < nodeCount; ++id) {
+                if (index.isPlayable(id))
+                    ranks_.emplace(index.path(id), rank++);
+            }
+            playCounts_ = countPlays(historyEntries);
+            weights.assign(rank, playCountWeight(0));
+            for (const auto & count : playCounts_)
+                weights[count.first] = playCountWeight(count.second);
+            break;
+        }
+    }
+    weights_ = FenwickTree(std::move(weights));
+}
+
+void WeightedItemChooser::historyChanged(
+    const CommonTypes::ItemProducer & historyEntries)
+{
+    if (weighting_ != Weighting::historyPlayCount)
+        return;
+    PlayCounts counts = countPlays(historyEntries);
+    for (const auto & oldCount : playCounts_) {
+        const auto it = counts.find(oldCount.first);
+        const unsigned count = it == counts.end() ? 0 : it->second;
+        if (count != oldCount.second)
+            weights_.set(oldCount.first, playCountWeight(count));
+    }
+    for (const auto & count : counts) {
+        if (playCounts_.find(count.first) == playCounts_.end())
+            weights_.set(count.first, playCountWeight(count.second));
+    }
+    playCounts_ = std::move(counts);
+}
+
+ItemIndex::NodeId WeightedItemChooser::randomItem(std::mt19937 & engine) const
+{
+    const double target = RandomNumbers::fraction(engine) * weights_.total();
+    return index_->nthPlayable(0, ItemIndex::NodeId(weights_.find(target)));
+}
+
+
+void WeightedItemChooser::buildTopLevelEntryWeights(
+    std::vector<double> & weights) const
+{
+    const ItemIndex & index = * index_;
+    const ItemIndex::NodeId end = index.nodeCount();
+    // Descend while a single not playable node contains all other nodes.
+    ItemIndex::NodeId first = 0;
+    while (first != end && index.subtreeEnd(first) == end
+            && ! index.isPlayable(first)) {
+        ++first;
+    }
+    for (ItemIndex::NodeId entry = first; entry != end;
+            entry = index.subtreeEnd(entry)) {
+        const ItemIndex::NodeId entryEnd = index.subtreeEnd(entry);
+        const ItemIndex::NodeId count = index.playableCount(entry, entryEnd);
+        if (count == 0)
+            continue;
+        weights.insert(weights.end(), count, 1.0 / count);
+    }
+}
+
+WeightedItemChooser::PlayCounts WeightedItemChooser::countPlays(
+    const CommonTypes::ItemProducer & historyEntries) const
+{
+    PlayCounts counts;
+    historyEntries([&](const std::string & entry) {
+        const auto it = ranks_.find(entry);
+        if (it != ranks_.end())
+            ++counts[it->second];
+    });
+    return counts;
+}
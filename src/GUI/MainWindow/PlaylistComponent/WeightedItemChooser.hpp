@@ -0,0 +1,86 @@
+/*
+ This file is part of Venturous.
+ Copyright (C) 2026 Igor Kushnir <igorkuo AT Google mail>
+
+ Venturous is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Venturous is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ Venturous.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef VENTUROUS_WEIGHTED_ITEM_CHOOSER_HPP
+# define VENTUROUS_WEIGHTED_ITEM_CHOOSER_HPP
+
+# include "FenwickTree.hpp"
+# include "ItemIndex.hpp"
+# include "CommonTypes.hpp"
+# include "Preferences.hpp"
+
+# include <cstddef>
+# include <random>
+# include <unordered_map>
+# include <vector>
+# include <string>
+
+
+/// Chooses random playable nodes of ItemIndex with probabilities proportional
+/// to their weights. Weights are stored in a FenwickTree in tree order, so
+/// both choosing an item and changing its weight take logarithmic time.
+class WeightedItemChooser
+{
+public:
+    using Weighting = Preferences::Playback::RandomWeighting;
+
+    /// @brief Assigns weights to all playable nodes of index.
+    /// @param historyEntries Is used only if weighting is historyPlayCount.
+    /// NOTE: index must remain valid and unchanged while this chooser is
+    /// used.
+    /// Complexity: O(total length of paths of playable nodes + history size).
+    void build(const ItemIndex & index, Weighting weighting,
+               const CommonTypes::ItemProducer & historyEntries);
+
+    /// @brief Updates weights of items whose number of history entries has
+    /// changed. Does nothing unless weighting is historyPlayCount.
+    /// Complexity: O(history size + number of changed weights *
+    /// log(itemCount())).
+    void historyChanged(const CommonTypes::ItemProducer & historyEntries);
+
+    std::size_t itemCount() const { return weights_.size(); }
+
+    /// @return Id of random playable node.
+    /// NOTE: itemCount() must be positive.
+    /// Complexity: O(log(itemCount()) + log(index.nodeCount())).
+    ItemIndex::NodeId randomItem(std::mt19937 & engine) const;
+
+private:
+    /// Maps ranks of playable nodes (their numbers among playable nodes in
+    /// tree order) to numbers of their history entries.
+    using PlayCounts = std::unordered_map<ItemIndex::NodeId, unsigned>;
+
+    /// @brief Assigns equal total weight to each top-level entry.
+    void buildTopLevelEntryWeights(std::vector<double> & weights) const;
+    PlayCounts countPlays(
+        const CommonTypes::ItemProducer & historyEntries) const;
+    static double playCountWeight(unsigned playCount) {
+        return 1.0 / (1 + playCount);
+    }
+
+
+    const ItemIndex * index_ = nullptr;
+    Weighting weighting_ = Weighting::uniform;
+    FenwickTree weights_;
+    /// Maps paths of playable nodes to their ranks.
+    /// Is filled only if weighting_ is historyPlayCount.
+    std::unordered_map<std::string, ItemIndex::NodeId> ranks_;
+    PlayCounts playCounts_;
+};
+
+# endif // VENTUROUS_WEIGHTED_ITEM_CHOOSER_HPP
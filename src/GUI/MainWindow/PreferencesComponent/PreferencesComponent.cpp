@@ -16,11 +16,6 @@
  Venturous.  If not, see <http://www.gnu.org/licenses/>.
 */
 
-# ifdef DEBUG_VENTUROUS_PREFERENCES_COMPONENT
-# include <QtCoreUtilities/String.hpp>
-# include <iostream>
-# endif
-
 # include "PreferencesComponent.hpp"
 
 # include "PreferencesWindow.hpp"
@@ -29,6 +24,7 @@
 # include <QtWidgetsUtilities/Miscellaneous.hpp>
 # include <QtWidgetsUtilities/HandleErrors.hpp>
 
+# include <QtCoreUtilities/String.hpp>
 # include <QtCoreUtilities/Error.hpp>
 
 # include <CommonUtilities/ExceptionsToStderr.hpp>
@@ -37,6 +33,8 @@
 # include <QFileInfo>
 
 # include <cassert>
+# include <utility>
+# include <iostream>
 
 
 PreferencesComponent::PreferencesComponent(
@@ -44,24 +42,42 @@ PreferencesComponent::PreferencesComponent(
     const QString & preferencesDir, bool & cancelled)
     : preferences(), inputController_(inputController),
       preferencesFilename_(preferencesDir + APPLICATION_NAME ".xml"),
-      savedPreferences_(preferences)
+      snapshotFilename_(preferencesDir + APPLICATION_NAME ".snapshot"),
+      writer_(preferencesFilename_, snapshotFilename_)
 {
 # ifdef DEBUG_VENTUROUS_PREFERENCES_COMPONENT
     std::cout << "preferencesFilename_ = " <<
               QtUtilities::qStringToString(preferencesFilename_) << std::endl;
+    CommonUtilities::exceptionsToStderr([&] {
+        const bool compatible = Preferences::checkXmlImplementations(
+                                    preferencesDir + "xml-check.xml");
+        std::cout << "Streaming and DOM XML implementations of preferences "
+                  << (compatible ? "are" : "are NOT") << " compatible."
+                  << std::endl;
+        assert(compatible && "XML implementations must be interchangeable.");
+    }, VENTUROUS_ERROR_PREFIX "Checking XML implementations failed: ");
 # endif
 
     if (QFileInfo(preferencesFilename_).isFile()) {
-        if (handlePreferencesErrors([this] {
-        savedPreferences_.load(preferencesFilename_);
-        }, tr("Loading preferences failed"), false, & cancelled)) {
-            preferences = savedPreferences_;
+        if (preferences.loadSnapshot(snapshotFilename_, preferencesFilename_))
+            cancelled = false;
+        else {
+            Preferences loaded;
+            if (handlePreferencesErrors([&] {
+            loaded.load(preferencesFilename_);
+            }, tr("Loading preferences failed"), false, & cancelled)) {
+                preferences = std::move(loaded);
+                PreferencesWriter::writeSnapshot(
+                    preferences, preferencesFilename_, snapshotFilename_);
+            }
         }
-        else
-            savedPreferences_ = preferences;
+        preferences.resetModified();
     }
     else
         cancelled = false;
+
+    connect(& writer_, SIGNAL(writeFailed(QString)),
+            SLOT(onWriteFailed(QString)));
 }
 
 PreferencesComponent::~PreferencesComponent()
@@ -73,17 +89,18 @@ PreferencesComponent::~PreferencesComponent()
 
 void PreferencesComponent::setTheme(const Icons::Theme & theme)
 {
-    icons_.add = theme.add();
-    icons_.remove = theme.remove();
-    icons_.undo = theme.undo();
-    icons_.revert = theme.revert();
+    theme_ = & theme;
 }
 
 void PreferencesComponent::showPreferencesWindow(QWidget * const parent)
 {
     if (preferencesWindow_ == nullptr) {
+        assert(theme_ && "setTheme() must be called first.");
+        const PreferencesWindow::Icons icons { theme_->add(), theme_->remove(),
+                                               theme_->undo(),
+                                               theme_->revert() };
         preferencesWindow_.reset(
-            new PreferencesWindow(preferences, icons_, parent));
+            new PreferencesWindow(preferences, icons, parent));
         preferencesWindow_->setUiPreferences();
         connect(preferencesWindow_.get(), SIGNAL(preferencesUpdated()),
                 SLOT(onPreferencesUpdated()));
@@ -131,22 +148,42 @@ void PreferencesComponent::savePreferences(const bool silentMode)
 {
     if (! silentMode)
         emit aboutToSave();
-    if (preferences != savedPreferences_) {
+    if (writer_.cancel())
+        preferences.setModified();
+    if (preferences.isModified()) {
         if (handlePreferencesErrors([this] {
-        preferences.save(preferencesFilename_);
+        PreferencesWriter::writeFiles(preferences, preferencesFilename_,
+                                      snapshotFilename_);
         }, tr("Saving preferences failed"), silentMode)) {
-            savedPreferences_ = preferences;
+            preferences.resetModified();
         }
     }
 }
 
+void PreferencesComponent::scheduleSavingPreferences()
+{
+    emit aboutToSave();
+    if (preferences.isModified()) {
+        writer_.write(preferences);
+        preferences.resetModified();
+    }
+}
+
 
 void PreferencesComponent::onPreferencesUpdated()
 {
     if (preferences.savePreferencesToDiskImmediately)
-        savePreferences();
+        scheduleSavingPreferences();
     assert(preferencesWindow_ != nullptr);
     preferencesWindow_.release()->deleteLater();
     /// WARNING: repeated execution blocking is possible here!
     emit preferencesChanged();
 }
+
+void PreferencesComponent::onWriteFailed(const QString & errorMessage)
+{
+    std::cerr << VENTUROUS_ERROR_PREFIX "Saving preferences failed: "
+              << QtUtilities::qStringToString(errorMessage) << std::endl;
+    // Preferences will be written again at next save.
+    preferences.setModified();
+}
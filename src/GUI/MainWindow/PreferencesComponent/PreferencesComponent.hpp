@@ -19,6 +19,7 @@
 # ifndef VENTUROUS_PREFERENCES_COMPONENT_HPP
 # define VENTUROUS_PREFERENCES_COMPONENT_HPP
 
+# include "PreferencesWriter.hpp"
 # include "PreferencesWindow.hpp"
 # include "Preferences.hpp"
 
@@ -58,6 +59,9 @@ public:
     /// NOTE: does not block execution.
     ~PreferencesComponent();
 
+    /// @brief Sets theme that provides icons of preferences window.
+    /// NOTE: theme must remain valid throughout this PreferencesComponent's
+    /// lifetime.
     /// NOTE: does not block execution.
     void setTheme(const Icons::Theme & theme);
 
@@ -70,6 +74,8 @@ public:
     /// @brief Should be called before normal quit.
     void quit();
 
+    /// NOTE: modified sections must be marked (see Preferences::assign()),
+    /// otherwise modifications are not saved.
     Preferences preferences;
 
 signals:
@@ -79,7 +85,7 @@ signals:
 
     /// @brief Is emitted before saving preferences to disk unless saving is
     /// performed in destructor. Internal options should be updated via
-    /// preferences field in receiving slot.
+    /// preferences field in receiving slot and marked as modified.
     /// WARNING: signal receiver may not block execution.
     void aboutToSave();
 
@@ -101,21 +107,28 @@ private:
                                  bool silentMode = false,
                                  bool * cancelled = nullptr);
 
-    /// @brief Saves preferences to disk if (preferences != savedPreferences_).
+    /// @brief Saves preferences to disk synchronously if
+    /// preferences.isModified() or if background writing has not finished
+    /// successfully.
     /// @param silentMode If true, aboutToSave() is not emitted and execution
     /// is not blocked.
     void savePreferences(bool silentMode = false);
+    /// @brief Passes preferences to writer_ if preferences.isModified().
+    /// NOTE: does not block execution.
+    void scheduleSavingPreferences();
 
 
     QtUtilities::Widgets::InputController & inputController_;
     const QString preferencesFilename_;
-    PreferencesWindow::Icons icons_;
+    const QString snapshotFilename_;
+    const Icons::Theme * theme_ = nullptr;
 
-    Preferences savedPreferences_;
+    PreferencesWriter writer_;
     std::unique_ptr<PreferencesWindow> preferencesWindow_;
 
 private slots:
     void onPreferencesUpdated();
+    void onWriteFailed(const QString & errorMessage);
 };
 
 # endif // VENTUROUS_PREFERENCES_COMPONENT_HPP
@@ -0,0 +1,215 @@
+/*
+ This file is part of Venturous.
+ Copyright (C) 2026 Igor Kushnir <igorkuo AT Google mail>
+
+ Venturous is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Venturous is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ Venturous.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+# ifdef DEBUG_VENTUROUS_PREFERENCES_COMPONENT
+# include <iostream>
+# endif
+
+# include "PreferencesWriter.hpp"
+
+# include "Preferences.hpp"
+
+# include <QtXmlUtilities/WritingShortcuts.hpp>
+
+# include <QtCoreUtilities/Error.hpp>
+
+# include <QtGlobal>
+# include <QString>
+# include <QFile>
+# include <QMutexLocker>
+
+# ifdef Q_OS_WIN
+# include <QDir>
+# include <windows.h>
+# include <io.h>
+# else
+# include <cstdio>
+# include <unistd.h>
+# endif
+
+# include <utility>
+
+
+namespace
+{
+/// @brief Flushes written data of file to disk. Otherwise after a system crash
+/// the renamed file could turn out empty or truncated.
+/// @return true on success.
+bool syncFile(QFile & file)
+{
+# ifdef Q_OS_WIN
+    return _commit(file.handle()) == 0;
+# else
+    return fsync(file.handle()) == 0;
+# endif
+}
+
+/// @brief Renames source to destination, replacing destination atomically
+/// if it exists.
+/// @return true on success.
+bool replaceFile(const QString & source, const QString & destination)
+{
+# ifdef Q_OS_WIN
+    const QString nativeSource = QDir::toNativeSeparators(source);
+    const QString nativeDestination = QDir::toNativeSeparators(destination);
+    return MoveFileExW(
+               reinterpret_cast<const wchar_t *>(nativeSource.utf16()),
+               reinterpret_cast<const wchar_t *>(nativeDestination.utf16()),
+               MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+# else
+    // Unlike QFile::rename(), std::rename() overwrites destination.
+    return std::rename(QFile::encodeName(source).constData(),
+                       QFile::encodeName(destination).constData()) == 0;
+# endif
+}
+
+} // END unnamed namespace
+
+
+constexpr unsigned PreferencesWriter::writeDelay;
+
+void PreferencesWriter::writeFiles(const Preferences & preferences,
+                                   const QString & filename,
+                                   const QString & snapshotFilename)
+{
+    const QString temporaryFilename = filename + ".tmp";
+    {
+        QFile file(temporaryFilename);
+        if (! file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            throw QtUtilities::XmlWriting::WriteError(
+                tr("could not open %1 for writing.").arg(temporaryFilename));
+        }
+        preferences.save(file);
+        if (! syncFile(file)) {
+            file.close();
+            QFile::remove(temporaryFilename);
+            throw QtUtilities::XmlWriting::WriteError(
+                tr("could not sync %1 to disk.").arg(temporaryFilename));
+        }
+    }
+    if (! replaceFile(temporaryFilename, filename)) {
+        QFile::remove(temporaryFilename);
+        throw QtUtilities::XmlWriting::WriteError(
+            tr("could not replace %1.").arg(filename));
+    }
+    writeSnapshot(preferences, filename, snapshotFilename);
+}
+
+void PreferencesWriter::writeSnapshot(const Preferences & preferences,
+                                      const QString & filename,
+                                      const QString & snapshotFilename)
+{
+    if (! preferences.saveSnapshot(snapshotFilename, filename)) {
+        QFile::remove(snapshotFilename);
+# ifdef DEBUG_VENTUROUS_PREFERENCES_COMPONENT
+        std::cout << "Saving preferences snapshot failed." << std::endl;
+# endif
+    }
+}
+
+
+PreferencesWriter::PreferencesWriter(QString filename,
+                                     QString snapshotFilename,
+                                     QObject * const parent)
+    : QThread(parent), filename_(std::move(filename)),
+      snapshotFilename_(std::move(snapshotFilename))
+{
+}
+
+PreferencesWriter::~PreferencesWriter()
+{
+    {
+        const QMutexLocker locker(& mutex_);
+        stopping_ = true;
+        condition_.wakeAll();
+    }
+    wait();
+}
+
+void PreferencesWriter::write(Preferences preferences)
+{
+    {
+        const QMutexLocker locker(& mutex_);
+        pending_.reset(new Preferences(std::move(preferences)));
+        sinceLastRequest_.start();
+        condition_.wakeAll();
+    }
+    if (! isRunning())
+        start(QThread::LowPriority);
+}
+
+bool PreferencesWriter::cancel()
+{
+    const QMutexLocker locker(& mutex_);
+    const bool discarded = pending_ != nullptr;
+    pending_.reset();
+    condition_.wakeAll();
+    while (writing_)
+        condition_.wait(& mutex_);
+    const bool outdated = discarded || lastWriteFailed_;
+    // Caller is now responsible for writing preferences.
+    lastWriteFailed_ = false;
+    return outdated;
+}
+
+
+void PreferencesWriter::run()
+{
+    QMutexLocker locker(& mutex_);
+    while (true) {
+        while (! stopping_ && pending_ == nullptr)
+            condition_.wait(& mutex_);
+        // Wait until requests stop arriving.
+        qint64 remaining;
+        while (! stopping_ && pending_ != nullptr &&
+                (remaining = qint64(writeDelay) -
+                             sinceLastRequest_.elapsed()) > 0) {
+            condition_.wait(& mutex_, (unsigned long)(remaining));
+        }
+        if (stopping_)
+            return;
+        if (pending_ == nullptr) // Cancelled.
+            continue;
+
+        const std::unique_ptr<const Preferences> preferences =
+            std::move(pending_);
+        writing_ = true;
+        locker.unlock();
+
+        bool failed = false;
+        QString errorMessage;
+        try {
+            writeFiles(* preferences, filename_, snapshotFilename_);
+        }
+        catch (const QtUtilities::Error & error) {
+            failed = true;
+            errorMessage = QString::fromUtf8(error.what());
+        }
+
+        locker.relock();
+        writing_ = false;
+        lastWriteFailed_ = failed;
+        condition_.wakeAll();
+        if (failed) {
+            locker.unlock();
+            emit writeFailed(errorMessage);
+            locker.relock();
+        }
+    }
+}
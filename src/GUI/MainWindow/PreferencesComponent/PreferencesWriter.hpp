@@ -0,0 +1,109 @@
+/*
+ This file is part of Venturous.
+ Copyright (C) 2026 Igor Kushnir <igorkuo AT Google mail>
+
+ Venturous is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Venturous is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ Venturous.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+# ifndef VENTUROUS_PREFERENCES_WRITER_HPP
+# define VENTUROUS_PREFERENCES_WRITER_HPP
+
+# include "Preferences.hpp"
+
+# include <QString>
+# include <QMutex>
+# include <QWaitCondition>
+# include <QElapsedTimer>
+# include <QThread>
+
+# include <memory>
+
+
+/// Writes preferences to disk in a background thread, so that GUI is not
+/// blocked by file system.
+/// Requests are coalesced: preferences are written when no new request has
+/// arrived for writeDelay milliseconds, and only preferences passed with the
+/// last request are written.
+/// Preferences file is replaced atomically: preferences are saved to a
+/// temporary file, which is synced to disk and then renamed over the
+/// preferences file.
+/// Binary snapshot is updated after the preferences file.
+class PreferencesWriter : public QThread
+{
+    Q_OBJECT
+public:
+    static constexpr unsigned writeDelay = 1000;
+
+    /// @brief Saves preferences to filename atomically and updates snapshot.
+    /// Is used by background thread. Can be called directly to save
+    /// preferences synchronously.
+    /// NOTE: snapshot is removed if it can not be saved.
+    /// @throw QtUtilities::XmlWriting::WriteError In case of error.
+    static void writeFiles(const Preferences & preferences,
+                           const QString & filename,
+                           const QString & snapshotFilename);
+
+    /// @brief Saves snapshot that is bound to the current state of filename,
+    /// which must contain the same preferences. Removes snapshot in case of
+    /// failure: outdated snapshot would be rejected anyway, but removing it
+    /// spares hashing preferences file at next startup.
+    static void writeSnapshot(const Preferences & preferences,
+                              const QString & filename,
+                              const QString & snapshotFilename);
+
+
+    explicit PreferencesWriter(QString filename, QString snapshotFilename,
+                               QObject * parent = nullptr);
+    /// @brief Waits for the write in progress to finish and stops the thread.
+    /// Unwritten preferences are discarded, so cancel() should be called
+    /// first to find out if there are any.
+    ~PreferencesWriter() override;
+
+    /// @brief Schedules writing preferences. Replaces preferences of the
+    /// previous request if they were not written yet.
+    /// NOTE: does not block execution.
+    void write(Preferences preferences);
+
+    /// @brief Discards scheduled preferences and waits for the write in
+    /// progress to finish.
+    /// @return true if scheduled preferences were discarded or the last write
+    /// failed, that is if the preferences file is not up to date.
+    bool cancel();
+
+signals:
+    /// @brief Is emitted from background thread if writing preferences
+    /// fails. errorMessage describes the error.
+    void writeFailed(const QString & errorMessage);
+
+private:
+    void run() override;
+
+
+    const QString filename_;
+    const QString snapshotFilename_;
+
+    /// Protects all fields that follow.
+    QMutex mutex_;
+    QWaitCondition condition_;
+    /// Preferences that are scheduled for writing or nullptr.
+    std::unique_ptr<Preferences> pending_;
+    /// Is restarted with each request.
+    QElapsedTimer sinceLastRequest_;
+    bool writing_ = false;
+    bool lastWriteFailed_ = false;
+    bool stopping_ = false;
+};
+
+# endif // VENTUROUS_PREFERENCES_WRITER_HPP
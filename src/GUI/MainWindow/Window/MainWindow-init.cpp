@@ -27,7 +27,10 @@
 # include "PlaybackComponent.hpp"
 # include "PreferencesComponent.hpp"
 # include "Icons.hpp"
+# include "ActionIcons.hpp"
 # include "Actions.hpp"
+# include "CustomActionJobs.hpp"
+# include "CustomActionJobsWidget.hpp"
 # include "Preferences.hpp"
 
 # include <QtCoreUtilities/String.hpp>
@@ -42,6 +45,7 @@
 # include <QMenu>
 # include <QMenuBar>
 # include <QToolBar>
+# include <QDockWidget>
 # include <QApplication>
 
 # include <cassert>
@@ -52,12 +56,15 @@
 
 namespace
 {
-void initMenuBar(QMenuBar & menuBar, const Actions & actions)
+/// @param customActionJobs Shows/hides custom action jobs window.
+void initMenuBar(QMenuBar & menuBar, const Actions & actions,
+                 QAction * const customActionJobs)
 {
     {
         QMenu * const file = menuBar.addMenu(QObject::tr("&File"));
         file->addActions( { actions.file.preferences,
-                            actions.file.preferencesDirectory, actions.file.quit
+                            actions.file.preferencesDirectory, customActionJobs,
+                            actions.file.quit
                           });
     }
     {
@@ -72,7 +79,7 @@ void initMenuBar(QMenuBar & menuBar, const Actions & actions)
                                 pbA.next
                               });
         playback->addSeparator();
-        playback->addAction(pbA.playAll);
+        playback->addActions( { pbA.playAll, pbA.playRandomBatch });
         playback->addSeparator();
         {
             QMenu * const externalPlayer =
@@ -103,6 +110,8 @@ void initMenuBar(QMenuBar & menuBar, const Actions & actions)
         });
         playlist->addSeparator();
         playlist->addActions( { plA.load, plA.saveAs });
+        playlist->addSeparator();
+        playlist->addAction(plA.find);
     }
     {
         QMenu * const help = menuBar.addMenu(QObject::tr("&Help"));
@@ -176,21 +185,31 @@ MainWindow::MainWindow(
         return;
 
     const Preferences & preferences = preferencesComponent_->preferences;
-    {
-        std::unique_ptr<const Icons::Theme> theme(
-            new Icons::Theme(preferences.alwaysUseFallbackIcons));
-
-        actions_.reset(new Actions(* theme));
-        setWindowIcon(theme->venturous());
-        preferencesComponent_->setTheme(* theme);
-    }
-
-    initMenuBar(menuBar_, * actions_);
+    iconTheme_.reset(new Icons::Theme(preferences.alwaysUseFallbackIcons,
+                                      preferencesDir + "icon-cache"));
+    actionIcons_.reset(new Icons::ActionIcons(* iconTheme_));
+    actions_.reset(new Actions(* actionIcons_));
+    setWindowIcon(iconTheme_->venturous());
+    preferencesComponent_->setTheme(* iconTheme_);
+
+    customActionJobs_.reset(new CustomActions::JobScheduler);
+    QDockWidget * const jobsDockWidget =
+        new QDockWidget(tr("Custom action jobs"), this);
+    jobsDockWidget->setObjectName(jobsDockWidget->windowTitle());
+    jobsDockWidget->setWidget(
+        new CustomActions::JobsWidget(* customActionJobs_));
+    addDockWidget(Qt::BottomDockWidgetArea, jobsDockWidget);
+    // Is shown on demand unless restoreState() shows it.
+    jobsDockWidget->hide();
+    jobsDockWidget->toggleViewAction()->setText(tr("Custom action &jobs"));
+
+    initMenuBar(menuBar_, * actions_, jobsDockWidget->toggleViewAction());
     setMenuBar(& menuBar_);
 
     toolBar_.setObjectName(toolBar_.windowTitle());
     initToolBar(toolBar_, * actions_);
     addToolBar(& toolBar_);
+    actionIcons_->watchWidgets();
 
     const std::string preferencesDirString =
         QtUtilities::qStringToString(preferencesDir);
@@ -198,20 +217,30 @@ MainWindow::MainWindow(
     /// WARNING: repeated execution blocking is possible here!
     playbackComponent_.reset(
         new PlaybackComponent(* this, actions_->playback, inputController_,
-                              preferences, preferencesDirString, cancelled));
+                              preferences, * customActionJobs_,
+                              preferencesDirString, cancelled));
     if (cancelled)
         return;
     /// WARNING: repeated execution blocking is possible here!
     playlistComponent_.reset(
         new PlaylistComponent(* this, * actions_, inputController_,
-                              preferences,
+                              preferences, * customActionJobs_,
                               std::bind(
                                   & PlaybackComponent::isRecentHistoryEntry,
                                   playbackComponent_.get(),
                                   std::placeholders::_1, std::placeholders::_2),
+    [this](const CommonTypes::ItemConsumer & consume) {
+        playbackComponent_->forEachHistoryEntry(consume);
+    },
     [this](CommonTypes::ItemCollection items) {
         playbackComponent_->play(std::move(items));
     },
+    [this](const CommonTypes::ItemProducer & produceItems) {
+        playbackComponent_->playStreamed(produceItems);
+    },
+    [this](CommonTypes::ItemCollection items) {
+        playbackComponent_->playPushingToHistory(std::move(items));
+    },
     preferencesDirString, cancelled));
     if (cancelled)
         return;
@@ -225,10 +254,15 @@ MainWindow::MainWindow(
     connect(playbackComponent_.get(),
             SIGNAL(statusChanged(MediaPlayer::Status)),
             SLOT(onPlayerStatusChanged(MediaPlayer::Status)));
+    connect(playbackComponent_.get(), SIGNAL(historyChanged()),
+            playlistComponent_.get(), SLOT(historyChanged()));
 
     connect(playlistComponent_.get(), SIGNAL(editModeChanged()),
             SLOT(setWindowTitle()));
 
+    connect(customActionJobs_.get(), SIGNAL(playlistCleanUpRequested()),
+            actions_->playlist.cleanUp, SLOT(trigger()));
+
     connect(actions_->file.preferences, SIGNAL(triggered(bool)),
             SLOT(onFilePreferences()));
     connect(actions_->file.preferencesDirectory, SIGNAL(triggered(bool)),
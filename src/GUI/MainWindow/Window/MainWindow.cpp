@@ -27,7 +27,10 @@
 # include "PlaylistComponent.hpp"
 # include "PlaybackComponent.hpp"
 # include "PreferencesComponent.hpp"
+# include "Icons.hpp"
+# include "ActionIcons.hpp"
 # include "Actions.hpp"
+# include "CustomActionJobs.hpp"
 # include "Preferences.hpp"
 # include "SharedMemory.hpp"
 
@@ -35,10 +38,15 @@
 
 # include <QtWidgetsUtilities/Miscellaneous.hpp>
 
+# include <QtCoreUtilities/Miscellaneous.hpp>
+
 # include <QString>
 # include <QTimer>
 # include <QUrl>
 # include <QSharedMemory>
+# include <QFile>
+# include <QIODevice>
+# include <QFileSystemWatcher>
 # include <QCoreApplication>
 # include <QIcon>
 # include <QDesktopServices>
@@ -50,6 +58,7 @@
 # include <QSystemTrayIcon>
 
 # include <utility>
+# include <iostream>
 
 
 namespace
@@ -87,11 +96,14 @@ void MainWindow::setPreferencesNoComponents()
     else
         hideNotificationAreaIcon();
 
+    customActionJobs_->setMaxParallel(preferences.customActionsMaxParallel);
+
     if (int(preferences.ventoolCheckInterval) != ventoolCheckInterval_) {
         ventoolCheckInterval_ = int(preferences.ventoolCheckInterval);
         killTimer(timerIdentifier_);
         if (ventoolCheckInterval_ != 0)
             timerIdentifier_ = startTimer(ventoolCheckInterval_);
+        setVentoolCommandWatching();
     }
 
     Actions::AddingPolicy & dest = actions_->addingPolicy;
@@ -135,11 +147,15 @@ void MainWindow::showNotificationAreaIcon()
                                               pb.setExternalPlayerOptions,
                                               pb.updateStatus
                                             });
+            actionIcons_->setIcons(externalPlayerMenu->actions());
             iconMenu->addSeparator();
         }
         iconMenu->addActions( { actions_->file.preferences,
                                 actions_->file.quit
                               });
+        // The menu may be exported over D-Bus and never shown as a widget,
+        // and the icon is visible right away, so icons are not deferred.
+        actionIcons_->setIcons(iconMenu->actions());
 
         notificationAreaIcon_.reset(new QSystemTrayIcon(windowIcon(), this));
         notificationAreaIcon_->setContextMenu(iconMenu);
@@ -177,8 +193,43 @@ bool MainWindow::quit()
     return true;
 }
 
+void MainWindow::setVentoolCommandWatching()
+{
+    if (ventoolCheckInterval_ == 0) {
+        ventoolCommandWatcher_.reset();
+        return;
+    }
+    if (ventoolCommandWatcher_ != nullptr)
+        return;
+
+    const QString filename = SharedMemory::commandNotificationFilename();
+    {
+        QtUtilities::makePathTo(filename);
+        QFile file(filename);
+        if (! file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            return; // Periodic checking still works.
+    }
+    ventoolCommandWatcher_.reset(new QFileSystemWatcher);
+    ventoolCommandWatcher_->addPath(filename);
+    connect(ventoolCommandWatcher_.get(), SIGNAL(fileChanged(QString)),
+            SLOT(executeVentoolCommand()));
+}
+
 void MainWindow::timerEvent(QTimerEvent *)
 {
+    executeVentoolCommand();
+}
+
+void MainWindow::executeVentoolCommand()
+{
+    if (ventoolCommandWatcher_ != nullptr
+            && ventoolCommandWatcher_->files().empty()) {
+        // The file was replaced or removed - watch it anew.
+        const QString filename = SharedMemory::commandNotificationFilename();
+        if (QFile::exists(filename))
+            ventoolCommandWatcher_->addPath(filename);
+    }
+
     if (inputController_.blocked())
         return;
     using namespace SharedMemory;
@@ -219,6 +270,9 @@ void MainWindow::timerEvent(QTimerEvent *)
             case Symbol::playAll():
                 pb.playAll->trigger();
                 break;
+            case Symbol::playRandomBatch():
+                pb.playRandomBatch->trigger();
+                break;
             case Symbol::showExternal():
                 pb.showExternalPlayerWindow->trigger();
                 break;
@@ -280,10 +334,16 @@ void MainWindow::closeEvent(QCloseEvent * const event)
 void MainWindow::copyInternalOptionsToPreferences()
 {
     Preferences & preferences = preferencesComponent_->preferences;
-    preferences.playback.history.currentIndex =
-        playbackComponent_->currentHistoryEntryIndex();
-    preferences.windowGeometry = saveGeometry();
-    preferences.windowState = saveState();
+    Preferences::Playback & playback = preferences.playback;
+    const Preferences::Section section = Preferences::Section::internal;
+    preferences.assign(section, playback.history.currentIndex,
+                       playbackComponent_->currentHistoryEntryIndex());
+    preferences.assign(section, playback.shuffleSeed,
+                       playlistComponent_->shuffleSeed());
+    preferences.assign(section, playback.shuffleCursor,
+                       playlistComponent_->shuffleCursor());
+    preferences.assign(section, preferences.windowGeometry, saveGeometry());
+    preferences.assign(section, preferences.windowState, saveState());
 }
 
 void MainWindow::onPreferencesChanged()
@@ -359,28 +419,36 @@ void MainWindow::onPlaybackNext()
 
 void MainWindow::onAudioFileStateChanged()
 {
-    preferencesComponent_->preferences.addingPolicy.addFiles =
-        actions_->addingPolicy.audioFile->isChecked();
+    Preferences & preferences = preferencesComponent_->preferences;
+    preferences.assign(Preferences::Section::addingItems,
+                       preferences.addingPolicy.addFiles,
+                       actions_->addingPolicy.audioFile->isChecked());
     actions_->addingPolicy.primaryActionChanged();
 }
 
 void MainWindow::onMediaDirStateChanged()
 {
-    preferencesComponent_->preferences.addingPolicy.addMediaDirs =
-        actions_->addingPolicy.mediaDir->isChecked();
+    Preferences & preferences = preferencesComponent_->preferences;
+    preferences.assign(Preferences::Section::addingItems,
+                       preferences.addingPolicy.addMediaDirs,
+                       actions_->addingPolicy.mediaDir->isChecked());
     actions_->addingPolicy.primaryActionChanged();
 }
 
 void MainWindow::onBothAudioFileStateChanged()
 {
-    preferencesComponent_->preferences.addingPolicy.ifBothAddFiles =
-        actions_->addingPolicy.bothAudioFile->isChecked();
+    Preferences & preferences = preferencesComponent_->preferences;
+    preferences.assign(Preferences::Section::addingItems,
+                       preferences.addingPolicy.ifBothAddFiles,
+                       actions_->addingPolicy.bothAudioFile->isChecked());
 }
 
 void MainWindow::onBothMediaDirStateChanged()
 {
-    preferencesComponent_->preferences.addingPolicy.ifBothAddMediaDirs =
-        actions_->addingPolicy.bothMediaDir->isChecked();
+    Preferences & preferences = preferencesComponent_->preferences;
+    preferences.assign(Preferences::Section::addingItems,
+                       preferences.addingPolicy.ifBothAddMediaDirs,
+                       actions_->addingPolicy.bothMediaDir->isChecked());
 }
 
 void MainWindow::resetCommitDataState()
@@ -423,6 +491,10 @@ void MainWindow::onAboutToQuit()
     // in this case.
     if (playlistComponent_ != nullptr)
         copyInternalOptionsToPreferences();
+    if (iconTheme_ != nullptr && ! iconTheme_->saveCache()) {
+        std::cerr << VENTUROUS_ERROR_PREFIX "Saving icon cache failed."
+                  << std::endl;
+    }
 # ifdef DEBUG_VENTUROUS_MAIN_WINDOW
     std::cout << "About to quit..." << std::endl;
 # endif
@@ -36,7 +36,17 @@ class PlaylistComponent;
 class PlaybackComponent;
 class PreferencesComponent;
 struct Actions;
+namespace Icons
+{
+class Theme;
+class ActionIcons;
+}
+namespace CustomActions
+{
+class JobScheduler;
+}
 QT_FORWARD_DECLARE_CLASS(QSharedMemory)
+QT_FORWARD_DECLARE_CLASS(QFileSystemWatcher)
 QT_FORWARD_DECLARE_CLASS(QSessionManager)
 
 /// WARNING: each method can block execution if not stated otherwise.
@@ -81,6 +91,11 @@ private:
     /// @return true if quit is allowed, false if user cancelled it.
     bool quit();
 
+    /// @brief Starts or stops watching for Ventool commands
+    /// depending on ventoolCheckInterval_.
+    /// NOTE: does not block execution.
+    void setVentoolCommandWatching();
+
     void timerEvent(QTimerEvent *) override;
     void keyPressEvent(QKeyEvent *) override;
     void closeEvent(QCloseEvent *) override;
@@ -90,6 +105,8 @@ private:
     /// instance.
     std::unique_ptr<QSharedMemory> sharedMemory_;
 
+    std::unique_ptr<const Icons::Theme> iconTheme_;
+    std::unique_ptr<Icons::ActionIcons> actionIcons_;
     std::unique_ptr<Actions> actions_;
     QMenuBar menuBar_;
     QToolBar toolBar_;
@@ -102,16 +119,25 @@ private:
     QtUtilities::Widgets::WindowInputController inputController_;
 
     std::unique_ptr<PreferencesComponent> preferencesComponent_;
+    /// Runs commands of custom actions triggered in playlist and history.
+    std::unique_ptr<CustomActions::JobScheduler> customActionJobs_;
     std::unique_ptr<PlaybackComponent> playbackComponent_;
     std::unique_ptr<PlaylistComponent> playlistComponent_;
 
     std::unique_ptr<QSystemTrayIcon> notificationAreaIcon_;
+    /// Watches SharedMemory::commandNotificationFilename() so that Ventool
+    /// commands (e.g. "next" issued by external player at the end of track)
+    /// are executed without waiting for the next periodic check.
+    std::unique_ptr<QFileSystemWatcher> ventoolCommandWatcher_;
 
     int ventoolCheckInterval_ = 0;
     int timerIdentifier_ = 0;
     CommitDataState commitDataState_ = CommitDataState::none;
 
 private slots:
+    /// @brief Executes pending Ventool command if there is one.
+    void executeVentoolCommand();
+
     /// NOTE: does not block execution.
     void copyInternalOptionsToPreferences();
     void onPreferencesChanged();
@@ -34,6 +34,7 @@
 # include <QModelIndex>
 # include <QAbstractItemModel>
 # include <QIcon>
+# include <QBrush>
 # include <QTableWidgetItem>
 # include <QItemSelectionRange>
 # include <QItemSelection>
@@ -65,6 +66,16 @@ void setText(QTableWidget & table, int row, int column, const QString & text)
     table.setItem(row, column, item);
 }
 
+/// @brief Compiles command in item and marks item if command is invalid.
+void checkCommand(QTableWidgetItem & item)
+{
+    const QString error =
+        CustomActions::CommandTemplate(item.text()).error();
+    item.setToolTip(error.isEmpty() ? QString() :
+                    QObject::tr("Syntax error: %1").arg(error));
+    item.setForeground(error.isEmpty() ? QBrush() : QBrush(Qt::red));
+}
+
 void setBool(QTableWidget & table, int row, int column, bool value)
 {
     QTableWidgetItem * const item = new QTableWidgetItem;
@@ -85,7 +96,7 @@ namespace Columns
 {
 constexpr int enabled = 0, text = enabled + 1, command = text + 1,
               minArgN = 3, maxArgN = minArgN + 1, type = maxArgN + 1,
-              comment = type + 1, n = 7;
+              cleanUpPlaylist = type + 1, comment = cleanUpPlaylist + 1, n = 8;
 }
 
 struct CellWidgetValues {
@@ -114,9 +125,11 @@ void setRow(QTableWidget & table, int row, const CustomActions::Action & action)
 {
     setText(table, row, Columns::text, action.text);
     setText(table, row, Columns::command, action.command);
+    checkCommand(* table.item(row, Columns::command));
     setCellWidgetColumns(table, row, { action.minArgN, action.maxArgN,
                                        static_cast<int>(action.type)
                                      });
+    setBool(table, row, Columns::cleanUpPlaylist, action.cleanUpPlaylist);
     setText(table, row, Columns::comment, action.comment);
     /// NOTE: "enabled" column must be set last.
     setBool(table, row, Columns::enabled, action.enabled);
@@ -216,7 +229,7 @@ CustomActionsPage::CustomActionsPage(
     table_.setColumnCount(Columns::n);
     table_.setHorizontalHeaderLabels( {
         tr("Enabled"), tr("Text"), tr("Command"), tr("Min"), tr("Max"),
-        tr("Type"), tr("Comment")
+        tr("Type"), tr("Clean up"), tr("Comment")
     });
     connect(& table_, SIGNAL(cellChanged(int, int)),
             SLOT(onCellChanged(int, int)));
@@ -248,6 +261,23 @@ CustomActionsPage::CustomActionsPage(
 
         layout->addLayout(actionsLayout);
     }
+    {
+        QHBoxLayout * const maxParallelLayout = new QHBoxLayout;
+        maxParallelLayout->addWidget(
+            new QLabel(tr("Maximum parallel commands"), this));
+        maxParallelSpinBox_.setRange(
+            0, int(Preferences::maxCustomActionsMaxParallel));
+        maxParallelSpinBox_.setSpecialValueText(tr("CPU cores"));
+        maxParallelSpinBox_.setToolTip(
+            tr("Maximum number of simultaneously running commands of\n"
+               "custom action jobs (split into batches or cleaning up\n"
+               "playlist). Commands that exceed the limit wait in\n"
+               "the queue shown in \"Custom action jobs\" window."));
+        QtUtilities::Widgets::setFixedSizePolicy(& maxParallelSpinBox_);
+        maxParallelLayout->addWidget(& maxParallelSpinBox_);
+        maxParallelLayout->addStretch();
+        layout->addLayout(maxParallelLayout);
+    }
 }
 
 void CustomActionsPage::setUiPreferences(const Preferences & source)
@@ -257,6 +287,7 @@ void CustomActionsPage::setUiPreferences(const Preferences & source)
     for (std::size_t i = 0; i < actions.size(); ++i)
         setRow(table_, static_cast<int>(i), actions[i]);
     table_.resizeColumnsToContents();
+    maxParallelSpinBox_.setValue(int(source.customActionsMaxParallel));
 }
 
 void CustomActionsPage::writeUiPreferencesTo(Preferences & destination) const
@@ -276,8 +307,14 @@ void CustomActionsPage::writeUiPreferencesTo(Preferences & destination) const
             a.maxArgN = values.maxArgN;
             a.type = static_cast<CustomActions::Action::Type>(values.type);
         }
+        a.cleanUpPlaylist =
+            table_.item(row, Columns::cleanUpPlaylist)->checkState() ==
+            Qt::Checked;
         a.comment = table_.item(row, Columns::comment)->text();
     }
+    CustomActions::compileCommands(actions);
+    destination.customActionsMaxParallel =
+        unsigned(maxParallelSpinBox_.value());
 }
 
 
@@ -363,7 +400,12 @@ void CustomActionsPage::onCellChanged(const int row, const int column)
     std::cout << "Custom actions table: cell (" << row << ',' << column
               << ") changed." << std::endl;
 # endif
-    if (column == Columns::enabled) {
+    if (column == Columns::command) {
+        const bool blocked = table_.blockSignals(true);
+        checkCommand(* table_.item(row, column));
+        table_.blockSignals(blocked);
+    }
+    else if (column == Columns::enabled) {
         const bool blocked = table_.blockSignals(true);
         const bool enabled =
             table_.item(row, column)->checkState() == Qt::Checked;
@@ -421,6 +463,9 @@ void CustomActionsPage::onShowHelpToggled()
               "<i>Max</i>. <i>Max</i>=-1 means \"without upper bound\".").arg(
                ++number));
         al(tr("%1. <i>Type</i> - allowed type of selected items."));
+        al(tr("%1. <i>Clean up</i>: if checked, playlist is cleaned up after "
+              "the command finishes. Should be checked for actions that move "
+              "or remove items."));
         al(tr("%1. <i>Comment</i> - a field that is not used by the program. "
               "It can be used to provide user with additional information "
               "about the custom action."));
@@ -23,6 +23,7 @@
 
 # include <QtGlobal>
 # include <QTableWidget>
+# include <QSpinBox>
 
 # include <memory>
 
@@ -47,6 +48,7 @@ private:
 
 
     QTableWidget table_;
+    QSpinBox maxParallelSpinBox_;
     std::unique_ptr<QFrame> helpFrame_;
 
 private slots:
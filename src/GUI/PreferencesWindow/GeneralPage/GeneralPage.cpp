@@ -27,8 +27,6 @@
 # include <QFormLayout>
 # include <QCheckBox>
 
-# include <limits>
-
 
 namespace
 {
@@ -96,8 +94,7 @@ GeneralPage::GeneralPage(QWidget * const parent, const Qt::WindowFlags f)
 
 
     treeAutoUnfoldedLevelsSpinBox.setRange(
-        0, std::numeric_limits < decltype(
-            Preferences::treeAutoUnfoldedLevels) >::max());
+        0, Preferences::maxTreeAutoUnfoldedLevels);
     treeAutoUnfoldedLevelsSpinBox.setToolTip(tr("Number of items in playlist "
             "tree that would be unfolded by default."));
     QtUtilities::Widgets::setFixedSizePolicy(& treeAutoUnfoldedLevelsSpinBox);
@@ -145,7 +142,10 @@ GeneralPage::GeneralPage(QWidget * const parent, const Qt::WindowFlags f)
     checkIntervalSpinBox.setSingleStep(0.1);
     checkIntervalSpinBox.setToolTip(
         tr("Time interval between subsequent checks for %1 commands.\n"
-           "Shorter interval makes reactions to %1 commands more prompt.\n"
+           "Commands are normally executed immediately when issued;\n"
+           "periodic checks are a fallback for file systems that\n"
+           "do not report changes.\n"
+           "Shorter interval makes the fallback more prompt.\n"
            "Longer interval may slightly improve performance.").arg(TOOL_NAME));
     checkIntervalSpinBox.setSuffix("s");
     QtUtilities::Widgets::setFixedSizePolicy(& checkIntervalSpinBox);
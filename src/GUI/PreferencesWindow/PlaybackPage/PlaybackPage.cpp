@@ -123,6 +123,41 @@ PlaybackPage::PlaybackPage(QWidget * const parent, const Qt::WindowFlags f)
     layout->addRow(tr("Skip recent history item count"),
                    & skipRecentHistoryItemCountSpinBox);
 
+    fullShuffleCheckBox.setToolTip(
+        tr("If checked, random items are played in shuffled order:\n"
+           "each playable item is played exactly once per cycle.\n"
+           "Items added to playlist are inserted at their positions\n"
+           "in the order: those after the current position are played\n"
+           "in the current cycle, others - in the next one.\n"
+           "Skip recent history item count is ignored in this mode."));
+    layout->addRow(tr("Full shuffle"), & fullShuffleCheckBox);
+
+    randomWeightingComboBox.addItems( {
+        tr("Uniform"), tr("Equal for top-level entries"),
+        tr("Less for items in history")
+    });
+    randomWeightingComboBox.setToolTip(
+        tr("Determines how likely each item is to be chosen randomly:\n"
+           "uniform - all items are equally likely;\n"
+           "equal for top-level entries - each entry at the first level\n"
+           "where playlist tree branches is equally likely to contain\n"
+           "chosen item;\n"
+           "less for items in history - the more times item occurs in\n"
+           "history, the less likely it is to be chosen.\n"
+           "Random items chosen in full shuffle mode or among filtered\n"
+           "items are not affected."));
+    QtUtilities::Widgets::setFixedSizePolicy(& randomWeightingComboBox);
+    layout->addRow(tr("Random item weighting"), & randomWeightingComboBox);
+
+    randomBatchSizeSpinBox.setRange(
+        Preferences::Playback::minRandomBatchSize,
+        Preferences::Playback::maxRandomBatchSize);
+    randomBatchSizeSpinBox.setToolTip(
+        tr("The number of distinct random items that are played\n"
+           "by \"Play random batch\" action at once."));
+    QtUtilities::Widgets::setFixedSizePolicy(& randomBatchSizeSpinBox);
+    layout->addRow(tr("Random batch size"), & randomBatchSizeSpinBox);
+
 
     desktopNotificationsCheckBox.setToolTip(tr(
             "If checked, desktop notifications would be shown after\n"
@@ -167,6 +202,10 @@ void PlaybackPage::setUiPreferences(const Preferences & source)
     nextFromHistoryCheckBox.setChecked(playback.nextFromHistory);
     skipRecentHistoryItemCountSpinBox.setValue(
             static_cast<int>(playback.skipRecentHistoryItemCount));
+    fullShuffleCheckBox.setChecked(playback.fullShuffle);
+    randomWeightingComboBox.setCurrentIndex(static_cast<int>(
+            playback.randomWeighting));
+    randomBatchSizeSpinBox.setValue(static_cast<int>(playback.randomBatchSize));
     desktopNotificationsCheckBox.setChecked(playback.desktopNotifications);
     startupPolicyComboBox.setCurrentIndex(static_cast<int>(
             playback.startupPolicy));
@@ -190,6 +229,12 @@ void PlaybackPage::writeUiPreferencesTo(Preferences & destination) const
     playback.nextFromHistory = nextFromHistoryCheckBox.isChecked();
     playback.skipRecentHistoryItemCount =
         static_cast<unsigned>(skipRecentHistoryItemCountSpinBox.value());
+    playback.fullShuffle = fullShuffleCheckBox.isChecked();
+    playback.randomWeighting =
+        static_cast<Preferences::Playback::RandomWeighting>(
+            randomWeightingComboBox.currentIndex());
+    playback.randomBatchSize =
+        static_cast<unsigned>(randomBatchSizeSpinBox.value());
     playback.desktopNotifications = desktopNotificationsCheckBox.isChecked();
     playback.startupPolicy = static_cast<Preferences::Playback::StartupPolicy>(
                                  startupPolicyComboBox.currentIndex());
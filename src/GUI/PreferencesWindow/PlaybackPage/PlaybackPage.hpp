@@ -48,6 +48,9 @@ private:
     QDoubleSpinBox statusUpdateSpinBox;
     QCheckBox nextFromHistoryCheckBox;
     QSpinBox skipRecentHistoryItemCountSpinBox;
+    QCheckBox fullShuffleCheckBox;
+    QComboBox randomWeightingComboBox;
+    QSpinBox randomBatchSizeSpinBox;
     QCheckBox desktopNotificationsCheckBox;
     QComboBox startupPolicyComboBox;
     HistoryPreferencesFrame historyFrame_;
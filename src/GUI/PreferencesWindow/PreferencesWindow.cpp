@@ -106,10 +106,13 @@ void PreferencesWindow::keyPressEvent(QKeyEvent * const event)
 
 void PreferencesWindow::closeEvent(QCloseEvent *)
 {
+    const Preferences previous = preferences_;
     std::for_each(tabs_.cbegin(), tabs_.cend(),
                   std::bind(& PreferencesPage::writeUiPreferencesTo,
                             std::placeholders::_1, std::ref(preferences_)));
-    preferences_.preferencesWindowGeometry = saveGeometry();
+    preferences_.markModifiedSections(previous);
+    preferences_.assign(Preferences::Section::internal,
+                        preferences_.preferencesWindowGeometry, saveGeometry());
     emit preferencesUpdated();
 }
 
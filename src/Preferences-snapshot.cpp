@@ -0,0 +1,367 @@
+/*
+ This file is part of Venturous.
+ Copyright (C) 2026 Igor Kushnir <igorkuo AT Google mail>
+
+ Venturous is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Venturous is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ Venturous.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# include "Preferences.hpp"
+
+# include "CustomActions.hpp"
+# include "FilePattern.hpp"
+
+# include <VenturousCore/AddingItems.hpp>
+# include <VenturousCore/MediaPlayer.hpp>
+
+# include <QtGlobal>
+# include <QByteArray>
+# include <QString>
+# include <QIODevice>
+# include <QFile>
+# include <QFileInfo>
+# include <QDateTime>
+# include <QDataStream>
+# include <QCryptographicHash>
+
+# include <cstddef>
+# include <utility>
+
+
+namespace
+{
+constexpr quint32 snapshotMagic = 0x56505253;
+/// Must be incremented whenever snapshot layout or meaning of any stored value
+/// changes.
+constexpr quint32 snapshotFormatVersion = 1;
+/// Is supported by both Qt4 and Qt5.
+constexpr int dataStreamVersion = QDataStream::Qt_4_8;
+
+/// Identifies the state of XML preferences file that snapshot matches.
+struct XmlFileState {
+    qint64 lastModified = 0;
+    qint64 size = 0;
+    QByteArray md5;
+};
+
+/// @brief Reads modification time and size of file filename.
+/// @return false if file does not exist.
+bool getLastModifiedAndSize(const QString & filename, XmlFileState & state)
+{
+    const QFileInfo info(filename);
+    if (! info.isFile())
+        return false;
+    state.lastModified = info.lastModified().toMSecsSinceEpoch();
+    state.size = info.size();
+    return true;
+}
+
+/// @brief Computes MD5 hash of the contents of file filename.
+/// @return Empty byte array in case of error.
+QByteArray getMd5(const QString & filename)
+{
+    QFile file(filename);
+    if (! file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(file.readAll());
+    return hash.result();
+}
+
+/// @brief Reads a value stored as Stored and converts it to T.
+template <typename Stored, typename T>
+void read(QDataStream & stream, T & destination)
+{
+    Stored value {};
+    stream >> value;
+    destination = static_cast<T>(value);
+}
+
+/// @brief Reads a value stored as Stored and converts it to T if it is in
+/// range [0, max]. Otherwise marks stream as corrupted.
+/// Values are validated against the same limits as in XML file, so that a
+/// corrupted snapshot is rejected instead of producing invalid preferences.
+template <typename Stored, typename T, typename Limit>
+void readMax(QDataStream & stream, T & destination, const Limit max)
+{
+    Stored value {};
+    stream >> value;
+    if (value > max)
+        stream.setStatus(QDataStream::ReadCorruptData);
+    else
+        destination = static_cast<T>(value);
+}
+
+/// @brief Reads a value stored as Stored and converts it to T if it is in
+/// range [min, max]. Otherwise marks stream as corrupted.
+template <typename Stored, typename T, typename Limit>
+void readRange(QDataStream & stream, T & destination,
+               const Limit min, const Limit max)
+{
+    Stored value {};
+    stream >> value;
+    if (value < min || value > max)
+        stream.setStatus(QDataStream::ReadCorruptData);
+    else
+        destination = static_cast<T>(value);
+}
+
+/// @brief Reads a value stored as Stored and converts it to T if it is 0 or
+/// in range [min, max]. Otherwise marks stream as corrupted.
+template <typename Stored, typename T, typename Limit>
+void readRange0Allowed(QDataStream & stream, T & destination,
+                       const Limit min, const Limit max)
+{
+    Stored value {};
+    stream >> value;
+    if (value != 0 && (value < min || value > max))
+        stream.setStatus(QDataStream::ReadCorruptData);
+    else
+        destination = static_cast<T>(value);
+}
+
+inline bool isOk(const QDataStream & stream)
+{
+    return stream.status() == QDataStream::Ok;
+}
+
+
+void writeHistory(QDataStream & stream,
+                  const Preferences::Playback::History & history)
+{
+    stream << quint64(history.maxSize) << history.copyPlayedEntryToTop
+           << history.saveToDiskImmediately << qint32(history.nHiddenDirs)
+           << qint32(history.currentIndex);
+}
+
+void writePlayback(QDataStream & stream, const Preferences::Playback & playback)
+{
+    typedef Preferences::Playback P;
+    stream << quint32(playback.playerId)
+           << playback.autoSetExternalPlayerOptions
+           << playback.autoHideExternalPlayerWindow
+           << playback.exitExternalPlayerOnQuit
+           << quint32(playback.statusUpdateInterval)
+           << playback.nextFromHistory
+           << quint32(playback.skipRecentHistoryItemCount)
+           << playback.fullShuffle
+           << quint8(static_cast<P::RandomWeightingUnderlyingType>(
+                         playback.randomWeighting))
+           << quint32(playback.randomBatchSize)
+           << playback.desktopNotifications
+           << quint8(static_cast<P::StartupPolicyUnderlyingType>(
+                         playback.startupPolicy))
+           << quint64(playback.shuffleSeed) << quint64(playback.shuffleCursor);
+    writeHistory(stream, playback.history);
+}
+
+void writeFilePatternList(QDataStream & stream, const FilePatternList & list)
+{
+    stream << quint64(list.size());
+    for (const FilePattern & p : list)
+        stream << p.pattern << p.enabled;
+}
+
+void writeAddingPolicy(QDataStream & stream, const AddingItems::Policy & p)
+{
+    stream << p.addFiles << p.addMediaDirs << p.ifBothAddFiles
+           << p.ifBothAddMediaDirs;
+}
+
+void writeCustomActions(QDataStream & stream,
+                        const CustomActions::Actions & actions)
+{
+    stream << quint64(actions.size());
+    for (const CustomActions::Action & a : actions) {
+        stream << a.enabled << a.text << a.command << qint32(a.minArgN)
+               << qint32(a.maxArgN)
+               << quint8(static_cast<CustomActions::Action::TypeUnderlyingType>(
+                             a.type))
+               << a.comment << a.cleanUpPlaylist;
+    }
+}
+
+
+void readHistory(QDataStream & stream,
+                 Preferences::Playback::History & history)
+{
+    typedef Preferences::Playback::History H;
+    readMax<quint64>(stream, history.maxSize, quint64(H::maxMaxSize));
+    stream >> history.copyPlayedEntryToTop >> history.saveToDiskImmediately;
+    readRange<qint32>(stream, history.nHiddenDirs,
+                      H::minNHiddenDirs, H::maxNHiddenDirs);
+    readRange<qint32>(stream, history.currentIndex,
+                      H::multipleItemsIndex, int(H::maxMaxSize));
+}
+
+void readPlayback(QDataStream & stream, Preferences::Playback & playback)
+{
+    typedef Preferences::Playback P;
+    readMax<quint32>(
+        stream, playback.playerId,
+        static_cast<unsigned>(GetMediaPlayer::playerList().size() - 1));
+    stream >> playback.autoSetExternalPlayerOptions
+           >> playback.autoHideExternalPlayerWindow
+           >> playback.exitExternalPlayerOnQuit;
+    readRange0Allowed<quint32>(stream, playback.statusUpdateInterval,
+                               P::minStatusUpdateInterval,
+                               P::maxStatusUpdateInterval);
+    stream >> playback.nextFromHistory;
+    readMax<quint32>(stream, playback.skipRecentHistoryItemCount,
+                     P::maxSkipRecentHistoryItemCount);
+    stream >> playback.fullShuffle;
+    readMax<quint8>(stream, playback.randomWeighting, P::maxRandomWeighting);
+    readRange<quint32>(stream, playback.randomBatchSize,
+                       P::minRandomBatchSize, P::maxRandomBatchSize);
+    stream >> playback.desktopNotifications;
+    readMax<quint8>(stream, playback.startupPolicy, P::maxStartupPolicy);
+    read<quint64>(stream, playback.shuffleSeed);
+    read<quint64>(stream, playback.shuffleCursor);
+    readHistory(stream, playback.history);
+}
+
+void readFilePatternList(QDataStream & stream, FilePatternList & list)
+{
+    quint64 size = 0;
+    stream >> size;
+    list.clear();
+    // Size is not trusted for reserving memory: stream status is checked
+    // instead so that a corrupted size can not cause a huge allocation.
+    for (quint64 i = 0; i < size && isOk(stream); ++i) {
+        FilePattern p;
+        stream >> p.pattern >> p.enabled;
+        list.push_back(std::move(p));
+    }
+}
+
+void readAddingPolicy(QDataStream & stream, AddingItems::Policy & p)
+{
+    stream >> p.addFiles >> p.addMediaDirs >> p.ifBothAddFiles
+           >> p.ifBothAddMediaDirs;
+}
+
+void readCustomActions(QDataStream & stream, CustomActions::Actions & actions)
+{
+    quint64 size = 0;
+    stream >> size;
+    actions.clear();
+    for (quint64 i = 0; i < size && isOk(stream); ++i) {
+        using CustomActions::Action;
+        Action a = Action::getEmpty();
+        stream >> a.enabled >> a.text >> a.command;
+        readRange<qint32>(stream, a.minArgN,
+                          Action::minMinArgN, Action::maxMinArgN);
+        readRange<qint32>(stream, a.maxArgN,
+                          Action::minMaxArgN, Action::maxMaxArgN);
+        readMax<quint8>(stream, a.type, Action::maxType);
+        stream >> a.comment >> a.cleanUpPlaylist;
+        actions.push_back(std::move(a));
+    }
+    CustomActions::compileCommands(actions);
+}
+
+} // END unnamed namespace
+
+
+bool Preferences::saveSnapshot(const QString & snapshotFilename,
+                               const QString & xmlFilename) const
+{
+    XmlFileState xmlState;
+    if (! getLastModifiedAndSize(xmlFilename, xmlState))
+        return false;
+    xmlState.md5 = getMd5(xmlFilename);
+    if (xmlState.md5.isEmpty())
+        return false;
+
+    QFile file(snapshotFilename);
+    if (! file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    QDataStream stream(& file);
+    stream.setVersion(dataStreamVersion);
+    stream << snapshotMagic << snapshotFormatVersion
+           << xmlState.lastModified << xmlState.size << xmlState.md5;
+
+    stream << alwaysUseFallbackIcons << notificationAreaIcon
+           << startToNotificationArea << closeToNotificationArea << statusBar
+           << quint8(treeAutoUnfoldedLevels) << treeAutoCleanup
+           << savePreferencesToDiskImmediately << quint32(ventoolCheckInterval);
+    writePlayback(stream, playback);
+    writeFilePatternList(stream, addingPatterns.filePatterns);
+    writeFilePatternList(stream, addingPatterns.mediaDirFilePatterns);
+    writeAddingPolicy(stream, addingPolicy);
+    writeCustomActions(stream, customActions);
+    stream << quint32(customActionsMaxParallel);
+    stream << preferencesWindowGeometry << windowGeometry << windowState;
+
+    if (! isOk(stream) || ! file.flush()) {
+        file.close();
+        file.remove();
+        return false;
+    }
+    return true;
+}
+
+bool Preferences::loadSnapshot(const QString & snapshotFilename,
+                               const QString & xmlFilename)
+{
+    QFile file(snapshotFilename);
+    if (! file.open(QIODevice::ReadOnly))
+        return false;
+    QDataStream stream(& file);
+    stream.setVersion(dataStreamVersion);
+
+    quint32 magic = 0, formatVersion = 0;
+    stream >> magic >> formatVersion;
+    if (! isOk(stream) || magic != snapshotMagic ||
+            formatVersion != snapshotFormatVersion) {
+        return false;
+    }
+
+    XmlFileState snapshotXmlState;
+    stream >> snapshotXmlState.lastModified >> snapshotXmlState.size
+           >> snapshotXmlState.md5;
+    XmlFileState xmlState;
+    // Hashing XML file is cheaper than parsing it, but is still skipped if
+    // the snapshot is obviously outdated.
+    if (! isOk(stream) || ! getLastModifiedAndSize(xmlFilename, xmlState) ||
+            xmlState.lastModified != snapshotXmlState.lastModified ||
+            xmlState.size != snapshotXmlState.size ||
+            getMd5(xmlFilename) != snapshotXmlState.md5) {
+        return false;
+    }
+
+    Preferences p;
+    stream >> p.alwaysUseFallbackIcons >> p.notificationAreaIcon
+           >> p.startToNotificationArea >> p.closeToNotificationArea
+           >> p.statusBar;
+    readMax<quint8>(stream, p.treeAutoUnfoldedLevels,
+                    maxTreeAutoUnfoldedLevels);
+    stream >> p.treeAutoCleanup >> p.savePreferencesToDiskImmediately;
+    readRange0Allowed<quint32>(stream, p.ventoolCheckInterval,
+                               minVentoolCheckInterval,
+                               maxVentoolCheckInterval);
+    readPlayback(stream, p.playback);
+    readFilePatternList(stream, p.addingPatterns.filePatterns);
+    readFilePatternList(stream, p.addingPatterns.mediaDirFilePatterns);
+    readAddingPolicy(stream, p.addingPolicy);
+    readCustomActions(stream, p.customActions);
+    readMax<quint32>(stream, p.customActionsMaxParallel,
+                     maxCustomActionsMaxParallel);
+    stream >> p.preferencesWindowGeometry >> p.windowGeometry
+           >> p.windowState;
+
+    if (! isOk(stream) || ! stream.atEnd())
+        return false;
+    * this = std::move(p);
+    return true;
+}
@@ -0,0 +1,607 @@
+/*
+ This file is part of Venturous.
+ Copyright (C) 2026 Igor Kushnir <igorkuo AT Google mail>
+
+ Venturous is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Venturous is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ Venturous.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# include "Preferences.hpp"
+
+# include "PreferencesXmlNames.hpp"
+# include "CustomActions.hpp"
+# include "FilePattern.hpp"
+
+# include <VenturousCore/AddingItems.hpp>
+# include <VenturousCore/MediaPlayer.hpp>
+
+# include <QtXmlUtilities/ReadingShortcuts.hpp>
+# include <QtXmlUtilities/WritingShortcuts.hpp>
+
+# include <QtGlobal>
+# include <QByteArray>
+# include <QString>
+# include <QObject>
+# include <QIODevice>
+# include <QFile>
+# include <QXmlStreamReader>
+# include <QXmlStreamWriter>
+
+# include <cstdint>
+# include <cstddef>
+# include <limits>
+# include <type_traits>
+# include <utility>
+
+
+namespace
+{
+namespace Names = PreferencesXmlNames;
+
+/// Values are converted to text in the same way as QtXmlUtilities does it,
+/// so that files written by Preferences::save() and Preferences::saveDom()
+/// are interchangeable. Preferences::checkXmlImplementations() verifies this.
+class Writer
+{
+public:
+    explicit Writer(QIODevice & device) : writer_(& device) {
+        writer_.setAutoFormatting(true);
+    }
+
+    QXmlStreamWriter & writer() { return writer_; }
+
+    void startElement(const QString & name) { writer_.writeStartElement(name); }
+    void endElement() { writer_.writeEndElement(); }
+
+    void child(const QString & name, const QString & text) {
+        writer_.writeTextElement(name, text);
+    }
+    void child(const QString & name, const bool value) {
+        child(name, QString::number(int(value)));
+    }
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value>::type
+    child(const QString & name, const T value) {
+        child(name, QString::number(value));
+    }
+    void byteArrayChild(const QString & name, const QByteArray & value) {
+        child(name, QString::fromLatin1(value.toBase64()));
+    }
+    void hexChild(const QString & name, const std::uint64_t value) {
+        child(name, QString::number(qulonglong(value), 16));
+    }
+
+private:
+    QXmlStreamWriter writer_;
+};
+
+void writeHistory(Writer & w, const Preferences::Playback::History & history)
+{
+    using namespace Names::Playback::History;
+    w.startElement(localRoot());
+    w.child(maxSize(), history.maxSize);
+    w.child(copyPlayedEntryToTop(), history.copyPlayedEntryToTop);
+    w.child(saveToDiskImmediately(), history.saveToDiskImmediately);
+    w.child(nHiddenDirs(), history.nHiddenDirs);
+    w.child(currentIndex(), history.currentIndex);
+    w.endElement();
+}
+
+void writePlayback(Writer & w, const Preferences::Playback & playback)
+{
+    using namespace Names::Playback;
+    typedef Preferences::Playback P;
+    w.startElement(localRoot());
+
+    w.child(playerId(), playback.playerId);
+
+    w.child(autoSetExternalPlayerOptions(),
+            playback.autoSetExternalPlayerOptions);
+    w.child(autoHideExternalPlayerWindow(),
+            playback.autoHideExternalPlayerWindow);
+    w.child(exitExternalPlayerOnQuit(), playback.exitExternalPlayerOnQuit);
+
+    w.child(statusUpdateInterval(), playback.statusUpdateInterval);
+    w.child(nextFromHistory(), playback.nextFromHistory);
+    w.child(skipRecentHistoryItemCount(),
+            playback.skipRecentHistoryItemCount);
+    w.child(fullShuffle(), playback.fullShuffle);
+    w.child(randomWeighting(), static_cast<P::RandomWeightingUnderlyingType>(
+                playback.randomWeighting));
+    w.child(randomBatchSize(), playback.randomBatchSize);
+    w.child(desktopNotifications(), playback.desktopNotifications);
+    w.child(startupPolicy(), static_cast<P::StartupPolicyUnderlyingType>(
+                playback.startupPolicy));
+    w.hexChild(shuffleSeed(), playback.shuffleSeed);
+    w.hexChild(shuffleCursor(), playback.shuffleCursor);
+
+    writeHistory(w, playback.history);
+    w.endElement();
+}
+
+void writeFilePatternList(Writer & w, const QString & listName,
+                          const FilePatternList & list)
+{
+    using namespace Names::AddingItems;
+    w.startElement(listName);
+    for (const FilePattern & p : list) {
+        w.startElement(pattern());
+        w.writer().writeAttribute(enabled(), QString::number(int(p.enabled)));
+        w.writer().writeCharacters(p.pattern);
+        w.endElement();
+    }
+    w.endElement();
+}
+
+void writeAddingItems(Writer & w, const Preferences::AddingPatterns & patterns,
+                      const AddingItems::Policy & p)
+{
+    using namespace Names::AddingItems;
+    w.startElement(localRoot());
+    writeFilePatternList(w, filePatterns(), patterns.filePatterns);
+    writeFilePatternList(w, mediaDirFilePatterns(),
+                         patterns.mediaDirFilePatterns);
+
+    w.startElement(policy());
+    w.child(addFiles(), p.addFiles);
+    w.child(addMediaDirs(), p.addMediaDirs);
+    w.child(ifBothAddFiles(), p.ifBothAddFiles);
+    w.child(ifBothAddMediaDirs(), p.ifBothAddMediaDirs);
+    w.endElement();
+
+    w.endElement();
+}
+
+void writeCustomActions(Writer & w, const CustomActions::Actions & actions)
+{
+    using namespace Names::CustomActions;
+    w.startElement(localRoot());
+    for (const CustomActions::Action & a : actions) {
+        w.startElement(action());
+        w.child(enabled(), a.enabled);
+        w.child(text(), a.text);
+        w.child(command(), a.command);
+        w.child(minArgN(), a.minArgN);
+        w.child(maxArgN(), a.maxArgN);
+        w.child(type(), static_cast<CustomActions::Action::TypeUnderlyingType>(
+                    a.type));
+        w.child(comment(), a.comment);
+        w.child(cleanUpPlaylist(), a.cleanUpPlaylist);
+        w.endElement();
+    }
+    w.endElement();
+}
+
+
+/// @return Text of current element including text of its descendants, like
+/// QDomElement::text().
+/// NOTE: moves reader to the end of current element.
+inline QString readText(QXmlStreamReader & reader)
+{
+    return reader.readElementText(QXmlStreamReader::IncludeChildElements);
+}
+
+bool parse(const QString & text, bool & destination)
+{
+    const QString trimmed = text.trimmed();
+    if (trimmed == "1" || trimmed == "true")
+        destination = true;
+    else if (trimmed == "0" || trimmed == "false")
+        destination = false;
+    else
+        return false;
+    return true;
+}
+
+template <typename T>
+typename std::enable_if < std::is_integral<T>::value &&
+std::is_signed<T>::value, bool >::type
+parse(const QString & text, T & destination, const int base = 10)
+{
+    bool ok;
+    const qlonglong value = text.trimmed().toLongLong(& ok, base);
+    if (! ok || value < std::numeric_limits<T>::min() ||
+            value > std::numeric_limits<T>::max()) {
+        return false;
+    }
+    destination = T(value);
+    return true;
+}
+
+template <typename T>
+typename std::enable_if < std::is_integral<T>::value &&
+! std::is_signed<T>::value, bool >::type
+parse(const QString & text, T & destination, const int base = 10)
+{
+    bool ok;
+    const qulonglong value = text.trimmed().toULongLong(& ok, base);
+    if (! ok || value > std::numeric_limits<T>::max())
+        return false;
+    destination = T(value);
+    return true;
+}
+
+/// @brief Reads text of current element to destination if it is valid.
+/// @return true if destination was modified.
+template <typename T>
+bool readTo(QXmlStreamReader & reader, T & destination)
+{
+    return parse(readText(reader), destination);
+}
+
+inline bool readTo(QXmlStreamReader & reader, QString & destination)
+{
+    destination = readText(reader);
+    return true;
+}
+
+/// @brief Reads text of current element to destination if it is a valid
+/// value in range [0, max].
+template <typename T>
+bool readToMax(QXmlStreamReader & reader, T & destination, const T max)
+{
+    T value;
+    if (! readTo(reader, value) || value > max)
+        return false;
+    destination = value;
+    return true;
+}
+
+/// @brief Reads text of current element to destination if it is a valid
+/// value in range [min, max].
+template <typename T>
+bool readToRange(QXmlStreamReader & reader, T & destination,
+                 const T min, const T max)
+{
+    T value;
+    if (! readTo(reader, value) || value < min || value > max)
+        return false;
+    destination = value;
+    return true;
+}
+
+/// @brief Reads text of current element to destination if it is 0 or a
+/// valid value in range [min, max].
+template <typename T>
+bool readToRange0Allowed(QXmlStreamReader & reader, T & destination,
+                         const T min, const T max)
+{
+    T value;
+    if (! readTo(reader, value) || (value != 0 && (value < min || value > max)))
+        return false;
+    destination = value;
+    return true;
+}
+
+void readHexTo(QXmlStreamReader & reader, std::uint64_t & destination)
+{
+    parse(readText(reader), destination, 16);
+}
+
+void readByteArrayTo(QXmlStreamReader & reader, QByteArray & destination)
+{
+    destination = QByteArray::fromBase64(readText(reader).toLatin1());
+}
+
+
+void readHistory(QXmlStreamReader & reader,
+                 Preferences::Playback::History & history)
+{
+    using namespace Names::Playback::History;
+    typedef Preferences::Playback::History H;
+    while (reader.readNextStartElement()) {
+        const auto name = reader.name();
+        if (name == maxSize())
+            readToMax(reader, history.maxSize, H::maxMaxSize);
+        else if (name == copyPlayedEntryToTop())
+            readTo(reader, history.copyPlayedEntryToTop);
+        else if (name == saveToDiskImmediately())
+            readTo(reader, history.saveToDiskImmediately);
+        else if (name == nHiddenDirs()) {
+            readToRange(reader, history.nHiddenDirs,
+                        H::minNHiddenDirs, H::maxNHiddenDirs);
+        }
+        else if (name == currentIndex()) {
+            readToRange(reader, history.currentIndex,
+                        H::multipleItemsIndex, int(H::maxMaxSize));
+        }
+        else
+            reader.skipCurrentElement();
+    }
+}
+
+void readPlayback(QXmlStreamReader & reader, Preferences::Playback & playback)
+{
+    using namespace Names::Playback;
+    typedef Preferences::Playback P;
+    while (reader.readNextStartElement()) {
+        const auto name = reader.name();
+        if (name == playerId()) {
+            readToMax(reader, playback.playerId, static_cast<unsigned>(
+                          GetMediaPlayer::playerList().size() - 1));
+        }
+        else if (name == autoSetExternalPlayerOptions())
+            readTo(reader, playback.autoSetExternalPlayerOptions);
+        else if (name == autoHideExternalPlayerWindow())
+            readTo(reader, playback.autoHideExternalPlayerWindow);
+        else if (name == exitExternalPlayerOnQuit())
+            readTo(reader, playback.exitExternalPlayerOnQuit);
+        else if (name == statusUpdateInterval()) {
+            readToRange0Allowed(reader, playback.statusUpdateInterval,
+                                P::minStatusUpdateInterval,
+                                P::maxStatusUpdateInterval);
+        }
+        else if (name == nextFromHistory())
+            readTo(reader, playback.nextFromHistory);
+        else if (name == skipRecentHistoryItemCount()) {
+            readToMax(reader, playback.skipRecentHistoryItemCount,
+                      P::maxSkipRecentHistoryItemCount);
+        }
+        else if (name == fullShuffle())
+            readTo(reader, playback.fullShuffle);
+        else if (name == randomWeighting()) {
+            P::RandomWeightingUnderlyingType w;
+            if (readToMax(reader, w, P::maxRandomWeighting))
+                playback.randomWeighting = static_cast<P::RandomWeighting>(w);
+        }
+        else if (name == randomBatchSize()) {
+            readToRange(reader, playback.randomBatchSize,
+                        P::minRandomBatchSize, P::maxRandomBatchSize);
+        }
+        else if (name == desktopNotifications())
+            readTo(reader, playback.desktopNotifications);
+        else if (name == startupPolicy()) {
+            P::StartupPolicyUnderlyingType p;
+            if (readToMax(reader, p, P::maxStartupPolicy))
+                playback.startupPolicy = static_cast<P::StartupPolicy>(p);
+        }
+        else if (name == shuffleSeed())
+            readHexTo(reader, playback.shuffleSeed);
+        else if (name == shuffleCursor())
+            readHexTo(reader, playback.shuffleCursor);
+        else if (name == Names::Playback::History::localRoot())
+            readHistory(reader, playback.history);
+        else
+            reader.skipCurrentElement();
+    }
+}
+
+void readFilePatternList(QXmlStreamReader & reader, FilePatternList & list)
+{
+    using namespace Names::AddingItems;
+    list.clear();
+    while (reader.readNextStartElement()) {
+        if (reader.name() == pattern()) {
+            FilePattern p { QString(), true };
+            parse(reader.attributes().value(enabled()).toString(), p.enabled);
+            p.pattern = readText(reader);
+            list.push_back(std::move(p));
+        }
+        else
+            reader.skipCurrentElement();
+    }
+}
+
+void readAddingPolicy(QXmlStreamReader & reader, AddingItems::Policy & p)
+{
+    using namespace Names::AddingItems;
+    while (reader.readNextStartElement()) {
+        const auto name = reader.name();
+        if (name == addFiles())
+            readTo(reader, p.addFiles);
+        else if (name == addMediaDirs())
+            readTo(reader, p.addMediaDirs);
+        else if (name == ifBothAddFiles())
+            readTo(reader, p.ifBothAddFiles);
+        else if (name == ifBothAddMediaDirs())
+            readTo(reader, p.ifBothAddMediaDirs);
+        else
+            reader.skipCurrentElement();
+    }
+}
+
+void readAddingItems(QXmlStreamReader & reader,
+                     Preferences::AddingPatterns & patterns,
+                     AddingItems::Policy & policy)
+{
+    using namespace Names::AddingItems;
+    while (reader.readNextStartElement()) {
+        const auto name = reader.name();
+        if (name == filePatterns())
+            readFilePatternList(reader, patterns.filePatterns);
+        else if (name == mediaDirFilePatterns())
+            readFilePatternList(reader, patterns.mediaDirFilePatterns);
+        else if (name == Names::AddingItems::policy())
+            readAddingPolicy(reader, policy);
+        else
+            reader.skipCurrentElement();
+    }
+}
+
+CustomActions::Action readCustomAction(QXmlStreamReader & reader)
+{
+    using namespace Names::CustomActions;
+    using CustomActions::Action;
+    Action a = Action::getEmpty();
+    while (reader.readNextStartElement()) {
+        const auto name = reader.name();
+        if (name == enabled())
+            readTo(reader, a.enabled);
+        else if (name == text())
+            readTo(reader, a.text);
+        else if (name == command())
+            readTo(reader, a.command);
+        else if (name == minArgN()) {
+            readToRange(reader, a.minArgN,
+                        Action::minMinArgN, Action::maxMinArgN);
+        }
+        else if (name == maxArgN()) {
+            readToRange(reader, a.maxArgN,
+                        Action::minMaxArgN, Action::maxMaxArgN);
+        }
+        else if (name == type()) {
+            Action::TypeUnderlyingType t;
+            if (readToMax(reader, t, Action::maxType))
+                a.type = static_cast<Action::Type>(t);
+        }
+        else if (name == comment())
+            readTo(reader, a.comment);
+        else if (name == cleanUpPlaylist())
+            readTo(reader, a.cleanUpPlaylist);
+        else
+            reader.skipCurrentElement();
+    }
+    return a;
+}
+
+void readCustomActions(QXmlStreamReader & reader,
+                       CustomActions::Actions & actions)
+{
+    actions.clear();
+    while (reader.readNextStartElement()) {
+        if (reader.name() == Names::CustomActions::action())
+            actions.push_back(readCustomAction(reader));
+        else
+            reader.skipCurrentElement();
+    }
+    CustomActions::compileCommands(actions);
+}
+
+void readRoot(QXmlStreamReader & reader, Preferences & p)
+{
+    typedef Preferences P;
+    while (reader.readNextStartElement()) {
+        const auto name = reader.name();
+        if (name == Names::alwaysUseFallbackIcons())
+            readTo(reader, p.alwaysUseFallbackIcons);
+
+        else if (name == Names::notificationAreaIcon())
+            readTo(reader, p.notificationAreaIcon);
+        else if (name == Names::startToNotificationArea())
+            readTo(reader, p.startToNotificationArea);
+        else if (name == Names::closeToNotificationArea())
+            readTo(reader, p.closeToNotificationArea);
+
+        else if (name == Names::statusBar())
+            readTo(reader, p.statusBar);
+
+        else if (name == Names::treeAutoUnfoldedLevels()) {
+            readToMax(reader, p.treeAutoUnfoldedLevels,
+                      P::maxTreeAutoUnfoldedLevels);
+        }
+        else if (name == Names::treeAutoCleanup())
+            readTo(reader, p.treeAutoCleanup);
+
+        else if (name == Names::savePreferencesToDiskImmediately())
+            readTo(reader, p.savePreferencesToDiskImmediately);
+        else if (name == Names::ventoolCheckInterval()) {
+            readToRange0Allowed(reader, p.ventoolCheckInterval,
+                                P::minVentoolCheckInterval,
+                                P::maxVentoolCheckInterval);
+        }
+
+        else if (name == Names::Playback::localRoot())
+            readPlayback(reader, p.playback);
+        else if (name == Names::AddingItems::localRoot())
+            readAddingItems(reader, p.addingPatterns, p.addingPolicy);
+        else if (name == Names::CustomActions::localRoot())
+            readCustomActions(reader, p.customActions);
+        else if (name == Names::customActionsMaxParallel()) {
+            readToMax(reader, p.customActionsMaxParallel,
+                      P::maxCustomActionsMaxParallel);
+        }
+
+        else if (name == Names::preferencesWindowGeometry())
+            readByteArrayTo(reader, p.preferencesWindowGeometry);
+        else if (name == Names::windowGeometry())
+            readByteArrayTo(reader, p.windowGeometry);
+        else if (name == Names::windowState())
+            readByteArrayTo(reader, p.windowState);
+        else
+            reader.skipCurrentElement();
+    }
+}
+
+} // END unnamed namespace
+
+
+void Preferences::save(const QString & filename) const
+{
+    QFile file(filename);
+    if (! file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        throw QtUtilities::XmlWriting::WriteError(
+            QObject::tr("could not open %1 for writing.").arg(filename));
+    }
+    save(file);
+}
+
+void Preferences::save(QFile & file) const
+{
+    Writer w(file);
+    w.writer().writeStartDocument();
+    w.startElement(Names::root());
+
+    w.child(Names::alwaysUseFallbackIcons(), alwaysUseFallbackIcons);
+
+    w.child(Names::notificationAreaIcon(), notificationAreaIcon);
+    w.child(Names::startToNotificationArea(), startToNotificationArea);
+    w.child(Names::closeToNotificationArea(), closeToNotificationArea);
+
+    w.child(Names::statusBar(), statusBar);
+
+    w.child(Names::treeAutoUnfoldedLevels(), treeAutoUnfoldedLevels);
+    w.child(Names::treeAutoCleanup(), treeAutoCleanup);
+
+    w.child(Names::savePreferencesToDiskImmediately(),
+            savePreferencesToDiskImmediately);
+    w.child(Names::ventoolCheckInterval(), ventoolCheckInterval);
+
+    writePlayback(w, playback);
+    writeAddingItems(w, addingPatterns, addingPolicy);
+    writeCustomActions(w, customActions);
+    w.child(Names::customActionsMaxParallel(), customActionsMaxParallel);
+
+
+    w.byteArrayChild(Names::preferencesWindowGeometry(),
+                     preferencesWindowGeometry);
+    w.byteArrayChild(Names::windowGeometry(), windowGeometry);
+    w.byteArrayChild(Names::windowState(), windowState);
+
+    w.endElement();
+    w.writer().writeEndDocument();
+    if (w.writer().hasError() || ! file.flush()) {
+        throw QtUtilities::XmlWriting::WriteError(
+            QObject::tr("could not write to %1.").arg(file.fileName()));
+    }
+}
+
+
+void Preferences::load(const QString & filename)
+{
+    QFile file(filename);
+    if (! file.open(QIODevice::ReadOnly)) {
+        throw QtUtilities::XmlReading::ReadError(
+            QObject::tr("could not open %1 for reading.").arg(filename));
+    }
+    QXmlStreamReader reader(& file);
+    // Like loadDom(), ignores document with unexpected root.
+    if (reader.readNextStartElement() && reader.name() == Names::root())
+        readRoot(reader, * this);
+
+    if (reader.hasError()) {
+        throw QtUtilities::XmlReading::ReadError(
+            QObject::tr("error in %1 at line %2, column %3: %4").arg(
+                filename, QString::number(reader.lineNumber()),
+                QString::number(reader.columnNumber()), reader.errorString()));
+    }
+}
@@ -18,6 +18,7 @@
 
 # include "Preferences.hpp"
 
+# include "PreferencesXmlNames.hpp"
 # include "CustomActions.hpp"
 # include "FilePattern.hpp"
 
@@ -27,113 +28,46 @@
 # include <QtXmlUtilities/ReadingShortcuts.hpp>
 # include <QtXmlUtilities/WritingShortcuts.hpp>
 
-# include <CommonUtilities/FunctionConstant.hpp>
-
+# include <QByteArray>
 # include <QString>
 # include <QStringList>
 # include <QObject>
+# include <QFile>
 # include <QDomElement>
 # include <QDomDocument>
 
+# include <cstdint>
 # include <cstddef>
 # include <utility>
+# include <limits>
 
 
 namespace
 {
-namespace Names
-{
-# define VENTUROUS_preferences_string_constant(name, value) \
-    NAMESPACE_FUNCTION_CONSTANT(QString, name, value)
+namespace Names = PreferencesXmlNames;
 
-namespace Playback
-{
-namespace History
-{
-VENTUROUS_preferences_string_constant(localRoot, "History")
-VENTUROUS_preferences_string_constant(maxSize, "MaxSize")
-VENTUROUS_preferences_string_constant(copyPlayedEntryToTop,
-                                      "CopyPlayedEntryToTop")
-VENTUROUS_preferences_string_constant(saveToDiskImmediately,
-                                      "SaveToDiskImmediately")
-VENTUROUS_preferences_string_constant(nHiddenDirs, "HiddenDirsNumber")
-VENTUROUS_preferences_string_constant(currentIndex, "CurrentIndex")
-} // END namespace History
-
-VENTUROUS_preferences_string_constant(localRoot, "Playback")
-VENTUROUS_preferences_string_constant(playerId, "PlayerID")
-VENTUROUS_preferences_string_constant(autoSetExternalPlayerOptions,
-                                      "AutoSetExternalPlayerOptions")
-VENTUROUS_preferences_string_constant(autoHideExternalPlayerWindow,
-                                      "AutoHideExternalPlayerWindow")
-VENTUROUS_preferences_string_constant(exitExternalPlayerOnQuit,
-                                      "ExitExternalPlayerOnQuit")
-VENTUROUS_preferences_string_constant(statusUpdateInterval,
-                                      "StatusUpdateInterval")
-VENTUROUS_preferences_string_constant(nextFromHistory, "NextFromHistory")
-VENTUROUS_preferences_string_constant(skipRecentHistoryItemCount,
-                                      "SkipRecentHistoryItemCount")
-VENTUROUS_preferences_string_constant(desktopNotifications,
-                                      "DesktopNotifications")
-VENTUROUS_preferences_string_constant(startupPolicy, "StartupPolicy")
-} // END namespace Playback
-
-namespace AddingItems
-{
-VENTUROUS_preferences_string_constant(localRoot, "AddingItems")
-VENTUROUS_preferences_string_constant(filePatterns, "FilePatterns")
-VENTUROUS_preferences_string_constant(mediaDirFilePatterns,
-                                      "MediaDirFilePatterns")
-VENTUROUS_preferences_string_constant(pattern, "pattern")
-VENTUROUS_preferences_string_constant(enabled, "enabled")
-VENTUROUS_preferences_string_constant(policy, "Policy")
-VENTUROUS_preferences_string_constant(addFiles, "AddFiles")
-VENTUROUS_preferences_string_constant(addMediaDirs, "AddMediaDirs")
-VENTUROUS_preferences_string_constant(ifBothAddFiles, "IfBothAddFiles")
-VENTUROUS_preferences_string_constant(ifBothAddMediaDirs, "IfBothAddMediaDirs")
-} // END namespace AddingItems
-
-namespace CustomActions
-{
-VENTUROUS_preferences_string_constant(localRoot, "CustomActions")
-VENTUROUS_preferences_string_constant(action, "action")
-VENTUROUS_preferences_string_constant(enabled, "Enabled")
-VENTUROUS_preferences_string_constant(text, "Text")
-VENTUROUS_preferences_string_constant(command, "Command")
-VENTUROUS_preferences_string_constant(minArgN, "MinArgN")
-VENTUROUS_preferences_string_constant(maxArgN, "MaxArgN")
-VENTUROUS_preferences_string_constant(type, "Type")
-VENTUROUS_preferences_string_constant(comment, "Comment")
-} // END namespace CustomActions
-
-VENTUROUS_preferences_string_constant(root, APPLICATION_NAME)
-VENTUROUS_preferences_string_constant(alwaysUseFallbackIcons,
-                                      "AlwaysUseFallbackIcons")
-VENTUROUS_preferences_string_constant(notificationAreaIcon,
-                                      "NotificationAreaIcon")
-VENTUROUS_preferences_string_constant(startToNotificationArea,
-                                      "StartToNotificationArea")
-VENTUROUS_preferences_string_constant(closeToNotificationArea,
-                                      "CloseToNotificationArea")
-VENTUROUS_preferences_string_constant(statusBar, "StatusBar")
-VENTUROUS_preferences_string_constant(treeAutoUnfoldedLevels,
-                                      "TreeAutoUnfoldedLevels")
-VENTUROUS_preferences_string_constant(treeAutoCleanup, "TreeAutoCleanup")
-VENTUROUS_preferences_string_constant(savePreferencesToDiskImmediately,
-                                      "SavePreferencesToDiskImmediately")
-VENTUROUS_preferences_string_constant(ventoolCheckInterval,
-                                      "VentoolCheckInterval")
-
-VENTUROUS_preferences_string_constant(preferencesWindowGeometry,
-                                      "PreferencesWindowGeometry")
-VENTUROUS_preferences_string_constant(windowGeometry, "WindowGeometry")
-VENTUROUS_preferences_string_constant(windowState, "WindowState")
-
-# undef VENTUROUS_preferences_string_constant
-} // END namespace Names
+typedef QtUtilities::XmlWriting::Element XmlElement;
 
+inline QString toHex(const std::uint64_t value)
+{
+    return QString::number(qulonglong(value), 16);
+}
 
-typedef QtUtilities::XmlWriting::Element XmlElement;
+/// @brief Copies hexadecimal value of the unique child of parent with
+/// specified tag name to destination if it is present and valid.
+void copyUniqueChildsHexTextTo(const QDomElement & parent,
+                               const QString & tagName,
+                               std::uint64_t & destination)
+{
+    const QDomElement e =
+        QtUtilities::XmlReading::getUniqueChild(parent, tagName);
+    if (e.isNull())
+        return;
+    bool ok;
+    const qulonglong value = e.text().toULongLong(& ok, 16);
+    if (ok)
+        destination = value;
+}
 
 void appendHistory(XmlElement & parent,
                    const Preferences::Playback::History & history)
@@ -166,11 +100,19 @@ void appendPlayback(XmlElement & parent, const Preferences::Playback & playback)
     e.appendChild(nextFromHistory(), playback.nextFromHistory);
     e.appendChild(skipRecentHistoryItemCount(),
                   playback.skipRecentHistoryItemCount);
+    e.appendChild(fullShuffle(), playback.fullShuffle);
+    e.appendChild(randomWeighting(),
+                  static_cast <
+                  Preferences::Playback::RandomWeightingUnderlyingType >(
+                      playback.randomWeighting));
+    e.appendChild(randomBatchSize(), playback.randomBatchSize);
     e.appendChild(desktopNotifications(), playback.desktopNotifications);
     e.appendChild(startupPolicy(),
                   static_cast <
                   Preferences::Playback::StartupPolicyUnderlyingType >(
                       playback.startupPolicy));
+    e.appendChild(shuffleSeed(), toHex(playback.shuffleSeed));
+    e.appendChild(shuffleCursor(), toHex(playback.shuffleCursor));
 
     appendHistory(e, playback.history);
 }
@@ -224,6 +166,7 @@ void appendCustomActions(XmlElement & parent,
                       static_cast<CustomActions::Action::TypeUnderlyingType>(
                           a.type));
         e.appendChild(comment(), a.comment);
+        e.appendChild(cleanUpPlaylist(), a.cleanUpPlaylist);
     }
 }
 
@@ -278,6 +221,16 @@ void loadPlayback(const QDomElement & parent, Preferences::Playback & playback)
     copyUniqueChildsTextToMax(e, skipRecentHistoryItemCount(),
                               playback.skipRecentHistoryItemCount,
                               P::maxSkipRecentHistoryItemCount);
+    copyUniqueChildsTextTo(e, fullShuffle(), playback.fullShuffle);
+    {
+        P::RandomWeightingUnderlyingType w;
+        if (copyUniqueChildsTextToMax(e, randomWeighting(),
+                                      w, P::maxRandomWeighting)) {
+            playback.randomWeighting = static_cast<P::RandomWeighting>(w);
+        }
+    }
+    copyUniqueChildsTextToRange(e, randomBatchSize(), playback.randomBatchSize,
+                                P::minRandomBatchSize, P::maxRandomBatchSize);
     copyUniqueChildsTextTo(e, desktopNotifications(),
                            playback.desktopNotifications);
     {
@@ -287,6 +240,8 @@ void loadPlayback(const QDomElement & parent, Preferences::Playback & playback)
             playback.startupPolicy = static_cast<P::StartupPolicy>(p);
         }
     }
+    copyUniqueChildsHexTextTo(e, shuffleSeed(), playback.shuffleSeed);
+    copyUniqueChildsHexTextTo(e, shuffleCursor(), playback.shuffleCursor);
 
     loadHistory(e, playback.history);
 }
@@ -376,39 +331,43 @@ CustomActions::Actions defaultCustomActions()
         CustomActions::Action {
             QObject::tr("Open with default application"), "xdg-open ?",
             1, 1, CustomActions::Action::Type::anyItem, true,
-            xdgUtilsMustBeInstalled
+            xdgUtilsMustBeInstalled, false, CustomActions::CommandTemplate()
         },
         CustomActions::Action {
             QObject::tr("Open containing directory"), "xdg-open @",
             1, -1, CustomActions::Action::Type::anyItem, true,
-            xdgUtilsMustBeInstalled
+            xdgUtilsMustBeInstalled, false, CustomActions::CommandTemplate()
         },
         CustomActions::Action {
             QObject::tr("Open in file manager"), defaultFileManager + " ?",
             0, -1, CustomActions::Action::Type::anyItem, false,
             replaceCommandWith.arg(defaultFileManager,
-                                   QObject::tr("file manager"))
+                                   QObject::tr("file manager")),
+            false, CustomActions::CommandTemplate()
         },
         CustomActions::Action {
             QObject::tr("Open in VLC"), "vlc ?",
             0, -1, CustomActions::Action::Type::anyItem, false,
-            "VLC" + mustBeInstalled
+            "VLC" + mustBeInstalled, false, CustomActions::CommandTemplate()
         },
         CustomActions::Action {
             QObject::tr("View/edit text file"), defaultTextEditor + " ?",
             0, -1, CustomActions::Action::Type::file, false,
             replaceCommandWith.arg(defaultTextEditor,
-                                   QObject::tr("text editor"))
+                                   QObject::tr("text editor")),
+            false, CustomActions::CommandTemplate()
         },
         CustomActions::Action {
             QObject::tr("Move to music trash"), "mv ? ~/Music/trash/",
             1, -1, CustomActions::Action::Type::anyItem, false,
-            QObject::tr("~/Music/trash directory must exist.")
+            QObject::tr("~/Music/trash directory must exist."), true,
+            CustomActions::CommandTemplate()
         },
         CustomActions::Action {
             QObject::tr("Move to Trash"), "trash-put ?",
             1, -1, CustomActions::Action::Type::anyItem, false,
-            "trash-cli" + mustBeInstalled
+            "trash-cli" + mustBeInstalled, true,
+            CustomActions::CommandTemplate()
         }
     };
 
@@ -434,6 +393,7 @@ CustomActions::Actions defaultCustomActions()
     }
 # endif
 
+    CustomActions::compileCommands(actions);
     return actions;
 }
 
@@ -456,6 +416,7 @@ CustomActions::Action domElementToCustomAction(const QDomElement & e)
             a.type = static_cast<Action::Type>(t);
     }
     copyUniqueChildsTextTo(e, comment(), a.comment);
+    copyUniqueChildsTextTo(e, cleanUpPlaylist(), a.cleanUpPlaylist);
     return a;
 }
 
@@ -469,6 +430,7 @@ void loadCustomActions(const QDomElement & parent,
         return;
     actions = getChildren<CustomActions::Actions>(
                   e, action(), domElementToCustomAction);
+    CustomActions::compileCommands(actions);
 }
 
 } // END unnamed namespace
@@ -489,15 +451,21 @@ constexpr unsigned Preferences::Playback::minStatusUpdateInterval;
 constexpr unsigned Preferences::Playback::defaultStatusUpdateInterval;
 constexpr unsigned Preferences::Playback::maxStatusUpdateInterval;
 constexpr unsigned Preferences::Playback::maxSkipRecentHistoryItemCount;
+constexpr unsigned Preferences::Playback::minRandomBatchSize;
+constexpr unsigned Preferences::Playback::maxRandomBatchSize;
 constexpr Preferences::Playback::StartupPolicyUnderlyingType
 Preferences::Playback::maxStartupPolicy;
+constexpr Preferences::Playback::RandomWeightingUnderlyingType
+Preferences::Playback::maxRandomWeighting;
 
 Preferences::Playback::Playback()
     : playerId(0), autoSetExternalPlayerOptions(true),
       autoHideExternalPlayerWindow(false), exitExternalPlayerOnQuit(true),
       statusUpdateInterval(0), nextFromHistory(false),
-      skipRecentHistoryItemCount(0),
-      desktopNotifications(true), startupPolicy(StartupPolicy::doNothing)
+      skipRecentHistoryItemCount(0), fullShuffle(false),
+      randomWeighting(RandomWeighting::uniform), randomBatchSize(20),
+      desktopNotifications(true), startupPolicy(StartupPolicy::doNothing),
+      shuffleSeed(0), shuffleCursor(0)
 {}
 
 
@@ -513,6 +481,9 @@ AddingItems::Patterns Preferences::AddingPatterns::enabledPatternLists() const
 constexpr unsigned Preferences::minVentoolCheckInterval;
 constexpr unsigned Preferences::defaultVentoolCheckInterval;
 constexpr unsigned Preferences::maxVentoolCheckInterval;
+constexpr unsigned Preferences::maxCustomActionsMaxParallel;
+constexpr unsigned char Preferences::maxTreeAutoUnfoldedLevels;
+constexpr std::size_t Preferences::sectionCount;
 
 Preferences::Preferences()
     : addingPatterns(defaultAddingPatterns()),
@@ -526,10 +497,42 @@ Preferences::Preferences()
       treeAutoCleanup(false),
       savePreferencesToDiskImmediately(false),
       ventoolCheckInterval(defaultVentoolCheckInterval),
-      customActions(defaultCustomActions())
+      customActions(defaultCustomActions()),
+      customActionsMaxParallel(0)
 {}
 
-void Preferences::save(const QString & filename) const
+void Preferences::markModifiedSections(const Preferences & previous)
+{
+    if (alwaysUseFallbackIcons != previous.alwaysUseFallbackIcons ||
+            notificationAreaIcon != previous.notificationAreaIcon ||
+            startToNotificationArea != previous.startToNotificationArea ||
+            closeToNotificationArea != previous.closeToNotificationArea ||
+            statusBar != previous.statusBar ||
+            treeAutoUnfoldedLevels != previous.treeAutoUnfoldedLevels ||
+            treeAutoCleanup != previous.treeAutoCleanup ||
+            savePreferencesToDiskImmediately !=
+            previous.savePreferencesToDiskImmediately ||
+            ventoolCheckInterval != previous.ventoolCheckInterval) {
+        setModified(Section::general);
+    }
+    if (playback != previous.playback)
+        setModified(Section::playback);
+    if (addingPatterns != previous.addingPatterns ||
+            !(addingPolicy == previous.addingPolicy)) {
+        setModified(Section::addingItems);
+    }
+    if (customActionsMaxParallel != previous.customActionsMaxParallel ||
+            customActions != previous.customActions) {
+        setModified(Section::customActions);
+    }
+    if (preferencesWindowGeometry != previous.preferencesWindowGeometry ||
+            windowGeometry != previous.windowGeometry ||
+            windowState != previous.windowState) {
+        setModified(Section::internal);
+    }
+}
+
+void Preferences::saveDom(const QString & filename) const
 {
     using namespace QtUtilities::XmlWriting;
     Document doc(Names::root());
@@ -553,6 +556,8 @@ void Preferences::save(const QString & filename) const
     appendPlayback(root, playback);
     appendAddingItems(root, addingPatterns, addingPolicy);
     appendCustomActions(root, customActions);
+    root.appendChild(Names::customActionsMaxParallel(),
+                     customActionsMaxParallel);
 
 
     root.appendChildByteArray(Names::preferencesWindowGeometry(),
@@ -564,7 +569,7 @@ void Preferences::save(const QString & filename) const
 }
 
 
-void Preferences::load(const QString & filename)
+void Preferences::loadDom(const QString & filename)
 {
     using namespace QtUtilities::XmlReading;
     const QDomElement root = loadRoot(filename, Names::root());
@@ -583,8 +588,9 @@ void Preferences::load(const QString & filename)
 
     copyUniqueChildsTextTo(root, Names::statusBar(), statusBar);
 
-    copyUniqueChildsTextTo(root, Names::treeAutoUnfoldedLevels(),
-                           treeAutoUnfoldedLevels);
+    copyUniqueChildsTextToMax(root, Names::treeAutoUnfoldedLevels(),
+                              treeAutoUnfoldedLevels,
+                              maxTreeAutoUnfoldedLevels);
     copyUniqueChildsTextTo(root, Names::treeAutoCleanup(), treeAutoCleanup);
 
     copyUniqueChildsTextTo(root, Names::savePreferencesToDiskImmediately(),
@@ -597,6 +603,9 @@ void Preferences::load(const QString & filename)
     loadPlayback(root, playback);
     loadAddingItems(root, addingPatterns, addingPolicy);
     loadCustomActions(root, customActions);
+    copyUniqueChildsTextToMax(root, Names::customActionsMaxParallel(),
+                              customActionsMaxParallel,
+                              maxCustomActionsMaxParallel);
 
 
     copyUniqueChildsTextToByteArray(
@@ -606,6 +615,58 @@ void Preferences::load(const QString & filename)
     copyUniqueChildsTextToByteArray(root, Names::windowState(), windowState);
 }
 
+bool Preferences::checkXmlImplementations(const QString & filename)
+{
+    typedef Playback P;
+    Preferences original;
+    // Every section differs from defaults. Texts contain characters that
+    // must be escaped in XML.
+    original.alwaysUseFallbackIcons = ! original.alwaysUseFallbackIcons;
+    original.statusBar = ! original.statusBar;
+    original.treeAutoUnfoldedLevels = maxTreeAutoUnfoldedLevels;
+    original.ventoolCheckInterval = 0;
+
+    original.playback.randomWeighting = P::RandomWeighting::historyPlayCount;
+    original.playback.randomBatchSize = P::maxRandomBatchSize;
+    original.playback.startupPolicy = P::StartupPolicy::playbackNextRandom;
+    original.playback.shuffleSeed = 0xfedcba9876543210u;
+    original.playback.shuffleCursor =
+        std::numeric_limits<std::uint64_t>::max();
+    original.playback.history.nHiddenDirs = P::History::minNHiddenDirs;
+    original.playback.history.currentIndex = P::History::multipleItemsIndex;
+
+    original.addingPatterns.filePatterns.push_back( { "*<&>\"'.x", false });
+    original.addingPolicy.addFiles = ! original.addingPolicy.addFiles;
+
+    {
+        CustomActions::Action a = CustomActions::Action::getEmpty();
+        a.enabled = true;
+        a.text = "<Check & \"compare\">";
+        a.command = "echo \"?\" @";
+        a.minArgN = CustomActions::Action::maxMinArgN;
+        a.maxArgN = CustomActions::Action::minMaxArgN;
+        a.type = CustomActions::Action::Type::directory;
+        a.comment = "'Comment'";
+        a.cleanUpPlaylist = true;
+        original.customActions.push_back(std::move(a));
+        CustomActions::compileCommands(original.customActions);
+    }
+    original.customActionsMaxParallel = maxCustomActionsMaxParallel;
+
+    original.windowGeometry = QByteArray("\0\x01\xff", 3);
+
+    Preferences domLoaded;
+    original.save(filename);
+    domLoaded.loadDom(filename);
+
+    Preferences streamLoaded;
+    original.saveDom(filename);
+    streamLoaded.load(filename);
+
+    QFile::remove(filename);
+    return domLoaded == original && streamLoaded == original;
+}
+
 
 bool operator == (const Preferences::Playback::History & lhs,
                   const Preferences::Playback::History & rhs)
@@ -629,8 +690,13 @@ bool operator == (const Preferences::Playback & lhs,
            lhs.statusUpdateInterval == rhs.statusUpdateInterval &&
            lhs.nextFromHistory == rhs.nextFromHistory &&
            lhs.skipRecentHistoryItemCount == rhs.skipRecentHistoryItemCount &&
+           lhs.fullShuffle == rhs.fullShuffle &&
+           lhs.randomWeighting == rhs.randomWeighting &&
+           lhs.randomBatchSize == rhs.randomBatchSize &&
            lhs.desktopNotifications == rhs.desktopNotifications &&
-           lhs.startupPolicy == rhs.startupPolicy;
+           lhs.startupPolicy == rhs.startupPolicy &&
+           lhs.shuffleSeed == rhs.shuffleSeed &&
+           lhs.shuffleCursor == rhs.shuffleCursor;
 }
 
 bool operator == (const Preferences::AddingPatterns & lhs,
@@ -663,6 +729,7 @@ bool operator == (const Preferences & lhs, const Preferences & rhs)
            lhs.ventoolCheckInterval == rhs.ventoolCheckInterval &&
 
            lhs.customActions == rhs.customActions &&
+           lhs.customActionsMaxParallel == rhs.customActionsMaxParallel &&
 
            lhs.preferencesWindowGeometry == rhs.preferencesWindowGeometry &&
            lhs.windowGeometry == rhs.windowGeometry &&
@@ -24,13 +24,27 @@
 
 # include <VenturousCore/AddingItems.hpp>
 
+# include <QtGlobal>
 # include <QByteArray>
 # include <QString>
 
+# include <cstdint>
 # include <cstddef>
+# include <utility>
+# include <bitset>
+
+
+QT_FORWARD_DECLARE_CLASS(QFile)
 
 
 /// Manages preferences. Saves and loads them in XML format.
+/// Both streaming and DOM-based implementations of XML input/output are
+/// available; they produce and accept the same schema.
+/// Tracks which sections were modified since the last resetModified() call,
+/// so checking whether preferences need saving does not require comparing
+/// them with the saved copy.
+/// NOTE: code that modifies fields directly must call setModified() for the
+/// corresponding section or use assign().
 class Preferences
 {
 public:
@@ -60,11 +74,28 @@ public:
             playbackNextRandom, playbackNext
         };
 
+        typedef unsigned char RandomWeightingUnderlyingType;
+        /// Determines probabilities of choosing random items.
+        enum class RandomWeighting : RandomWeightingUnderlyingType
+        {
+            /// All items are equally likely to be chosen.
+            uniform = 0,
+            /// All top-level entries (at the first level where the tree
+            /// branches) are equally likely to contain chosen item.
+            topLevelEntries,
+            /// Item's weight is inversely proportional to 1 + the number of
+            /// its entries in history.
+            historyPlayCount
+        };
+
         static constexpr unsigned minStatusUpdateInterval = 300,
                                   defaultStatusUpdateInterval = 2000,
                                   maxStatusUpdateInterval = 30 * 1000;
         static constexpr unsigned maxSkipRecentHistoryItemCount = 99;
+        static constexpr unsigned minRandomBatchSize = 2,
+                                  maxRandomBatchSize = 999;
         static constexpr StartupPolicyUnderlyingType maxStartupPolicy = 4;
+        static constexpr RandomWeightingUnderlyingType maxRandomWeighting = 2;
 
         explicit Playback();
 
@@ -77,8 +108,17 @@ public:
         unsigned statusUpdateInterval;
         bool nextFromHistory;
         unsigned skipRecentHistoryItemCount;
+        /// If true, random items are played in shuffled order, each item
+        /// exactly once per cycle.
+        bool fullShuffle;
+        RandomWeighting randomWeighting;
+        /// Number of distinct random items played by "Play random batch".
+        unsigned randomBatchSize;
         bool desktopNotifications;
         StartupPolicy startupPolicy;
+
+        /// Internal options. Key of shuffled order and position in it.
+        std::uint64_t shuffleSeed, shuffleCursor;
     }
     playback;
 
@@ -95,20 +135,104 @@ public:
     static constexpr unsigned minVentoolCheckInterval = 100,
                               defaultVentoolCheckInterval = 1000,
                               maxVentoolCheckInterval = 9999;
+    static constexpr unsigned maxCustomActionsMaxParallel = 99;
+    static constexpr unsigned char maxTreeAutoUnfoldedLevels = 99;
+
+    /// Groups of fields whose modifications are tracked.
+    enum class Section : unsigned char
+    {
+        /// Fields edited in General preferences page.
+        general = 0,
+        playback, addingItems, customActions,
+        /// Internal options: geometry, state, history index, shuffle cursor.
+        internal
+    };
+    static constexpr std::size_t sectionCount = 5;
 
 
     explicit Preferences();
 
+    /// @return true if any section was modified since the last
+    /// resetModified() call. Complexity: O(1).
+    bool isModified() const { return modified_.any(); }
+    bool isModified(Section section) const {
+        return modified_.test(std::size_t(section));
+    }
+    void setModified(Section section) { modified_.set(std::size_t(section)); }
+    /// @brief Marks all sections as modified.
+    void setModified() { modified_.set(); }
+    /// @brief Should be called after preferences are saved or loaded.
+    void resetModified() { modified_.reset(); }
+
+    /// @brief Assigns value to field, which must belong to section. Marks
+    /// section as modified if field's value changes.
+    template <typename T>
+    void assign(Section section, T & field, T value);
+
+    /// @brief Marks sections whose fields differ from those of previous as
+    /// modified.
+    /// NOTE: compares all fields, so should be used only after bulk updates,
+    /// for example when preferences window is closed.
+    void markModifiedSections(const Preferences & previous);
+
     /// @brief Saves preferences to file filename.
+    /// Elements are written as they are produced, without building a
+    /// document tree in memory.
     /// @throw QtUtilities::XmlWriting::WriteError In case of error.
     void save(const QString & filename) const;
+    /// @brief Saves preferences to file, which must be open for writing.
+    /// file is flushed but not closed, so the caller can sync it to disk.
+    /// @throw QtUtilities::XmlWriting::WriteError In case of error.
+    void save(QFile & file) const;
 
     /// @brief Loads preferences from file filename.
+    /// The file is parsed incrementally, without building a document tree in
+    /// memory.
     /// @throw QtUtilities::XmlReading::ReadError In case of error.
     /// NOTE: in case of failure (throwing ReadError) state of this becomes
     /// undefined.
     void load(const QString & filename);
 
+    /// @brief Equivalent to save(), but builds QDomDocument first.
+    /// Produces the same schema as save(). Is kept for comparison.
+    /// @throw QtUtilities::XmlWriting::WriteError In case of error.
+    void saveDom(const QString & filename) const;
+
+    /// @brief Equivalent to load(), but parses the whole QDomDocument first.
+    /// Is kept for comparison.
+    /// @throw QtUtilities::XmlReading::ReadError In case of error.
+    /// NOTE: in case of failure (throwing ReadError) state of this becomes
+    /// undefined.
+    void loadDom(const QString & filename);
+
+    /// @brief Checks that both XML implementations produce and accept the same
+    /// schema: saves non-default preferences to file filename with save() and
+    /// loads them with loadDom(), then saves them with saveDom() and loads
+    /// them with load().
+    /// NOTE: filename is overwritten and then removed.
+    /// @return true if loaded preferences are equal to saved ones both times.
+    /// @throw QtUtilities::XmlWriting::WriteError,
+    /// QtUtilities::XmlReading::ReadError In case of I/O error.
+    static bool checkXmlImplementations(const QString & filename);
+
+    /// @brief Saves preferences to binary snapshot file snapshotFilename.
+    /// The snapshot is bound to the current state of xmlFilename, which must
+    /// contain the same preferences (should be called right after
+    /// save(xmlFilename)).
+    /// @return true on success.
+    bool saveSnapshot(const QString & snapshotFilename,
+                      const QString & xmlFilename) const;
+
+    /// @brief Loads preferences from binary snapshot file snapshotFilename,
+    /// which is much faster than load(xmlFilename).
+    /// @return true on success. false if snapshot is missing, corrupted
+    /// (including values out of the ranges that load() accepts), has an
+    /// incompatible format version or does not match current state of
+    /// xmlFilename (modification time, size or hash). this is not modified
+    /// in this case.
+    bool loadSnapshot(const QString & snapshotFilename,
+                      const QString & xmlFilename);
+
 
     AddingPatterns addingPatterns;
     AddingItems::Policy addingPolicy;
@@ -122,14 +246,30 @@ public:
     unsigned ventoolCheckInterval;
 
     CustomActions::Actions customActions;
+    /// Maximum number of simultaneously running custom action commands.
+    /// 0 means the number of CPU cores.
+    unsigned customActionsMaxParallel;
 
     /// Internal options follow.
     QByteArray preferencesWindowGeometry;
     QByteArray windowGeometry;
     QByteArray windowState;
+
+private:
+    std::bitset<sectionCount> modified_;
 };
 
 
+template <typename T>
+void Preferences::assign(const Section section, T & field, T value)
+{
+    if (field != value) {
+        field = std::move(value);
+        setModified(section);
+    }
+}
+
+
 bool operator == (const Preferences::Playback::History & lhs,
                   const Preferences::Playback::History & rhs);
 
@@ -157,6 +297,7 @@ inline bool operator != (const Preferences::AddingPatterns & lhs,
     return !(lhs == rhs);
 }
 
+/// NOTE: modified sections are not compared.
 bool operator == (const Preferences & lhs, const Preferences & rhs);
 
 inline bool operator != (const Preferences & lhs, const Preferences & rhs)
@@ -0,0 +1,128 @@
+/*
+ This file is part of Venturous.
+ Copyright (C) 2026 Igor Kushnir <igorkuo AT Google mail>
+
+ Venturous is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Venturous is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ Venturous.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef VENTUROUS_PREFERENCES_XML_NAMES_HPP
+# define VENTUROUS_PREFERENCES_XML_NAMES_HPP
+
+# include <CommonUtilities/FunctionConstant.hpp>
+
+# include <QString>
+
+
+/// Names of elements and attributes in preferences XML file.
+/// Are shared by DOM and streaming XML implementations of Preferences.
+namespace PreferencesXmlNames
+{
+# define VENTUROUS_preferences_string_constant(name, value) \
+    NAMESPACE_FUNCTION_CONSTANT(QString, name, value)
+
+namespace Playback
+{
+namespace History
+{
+VENTUROUS_preferences_string_constant(localRoot, "History")
+VENTUROUS_preferences_string_constant(maxSize, "MaxSize")
+VENTUROUS_preferences_string_constant(copyPlayedEntryToTop,
+                                      "CopyPlayedEntryToTop")
+VENTUROUS_preferences_string_constant(saveToDiskImmediately,
+                                      "SaveToDiskImmediately")
+VENTUROUS_preferences_string_constant(nHiddenDirs, "HiddenDirsNumber")
+VENTUROUS_preferences_string_constant(currentIndex, "CurrentIndex")
+} // END namespace History
+
+VENTUROUS_preferences_string_constant(localRoot, "Playback")
+VENTUROUS_preferences_string_constant(playerId, "PlayerID")
+VENTUROUS_preferences_string_constant(autoSetExternalPlayerOptions,
+                                      "AutoSetExternalPlayerOptions")
+VENTUROUS_preferences_string_constant(autoHideExternalPlayerWindow,
+                                      "AutoHideExternalPlayerWindow")
+VENTUROUS_preferences_string_constant(exitExternalPlayerOnQuit,
+                                      "ExitExternalPlayerOnQuit")
+VENTUROUS_preferences_string_constant(statusUpdateInterval,
+                                      "StatusUpdateInterval")
+VENTUROUS_preferences_string_constant(nextFromHistory, "NextFromHistory")
+VENTUROUS_preferences_string_constant(skipRecentHistoryItemCount,
+                                      "SkipRecentHistoryItemCount")
+VENTUROUS_preferences_string_constant(fullShuffle, "FullShuffle")
+VENTUROUS_preferences_string_constant(randomWeighting, "RandomWeighting")
+VENTUROUS_preferences_string_constant(randomBatchSize, "RandomBatchSize")
+VENTUROUS_preferences_string_constant(desktopNotifications,
+                                      "DesktopNotifications")
+VENTUROUS_preferences_string_constant(startupPolicy, "StartupPolicy")
+VENTUROUS_preferences_string_constant(shuffleSeed, "ShuffleSeed")
+VENTUROUS_preferences_string_constant(shuffleCursor, "ShuffleCursor")
+} // END namespace Playback
+
+namespace AddingItems
+{
+VENTUROUS_preferences_string_constant(localRoot, "AddingItems")
+VENTUROUS_preferences_string_constant(filePatterns, "FilePatterns")
+VENTUROUS_preferences_string_constant(mediaDirFilePatterns,
+                                      "MediaDirFilePatterns")
+VENTUROUS_preferences_string_constant(pattern, "pattern")
+VENTUROUS_preferences_string_constant(enabled, "enabled")
+VENTUROUS_preferences_string_constant(policy, "Policy")
+VENTUROUS_preferences_string_constant(addFiles, "AddFiles")
+VENTUROUS_preferences_string_constant(addMediaDirs, "AddMediaDirs")
+VENTUROUS_preferences_string_constant(ifBothAddFiles, "IfBothAddFiles")
+VENTUROUS_preferences_string_constant(ifBothAddMediaDirs, "IfBothAddMediaDirs")
+} // END namespace AddingItems
+
+namespace CustomActions
+{
+VENTUROUS_preferences_string_constant(localRoot, "CustomActions")
+VENTUROUS_preferences_string_constant(action, "action")
+VENTUROUS_preferences_string_constant(enabled, "Enabled")
+VENTUROUS_preferences_string_constant(text, "Text")
+VENTUROUS_preferences_string_constant(command, "Command")
+VENTUROUS_preferences_string_constant(minArgN, "MinArgN")
+VENTUROUS_preferences_string_constant(maxArgN, "MaxArgN")
+VENTUROUS_preferences_string_constant(type, "Type")
+VENTUROUS_preferences_string_constant(comment, "Comment")
+VENTUROUS_preferences_string_constant(cleanUpPlaylist, "CleanUpPlaylist")
+} // END namespace CustomActions
+
+VENTUROUS_preferences_string_constant(root, APPLICATION_NAME)
+VENTUROUS_preferences_string_constant(alwaysUseFallbackIcons,
+                                      "AlwaysUseFallbackIcons")
+VENTUROUS_preferences_string_constant(notificationAreaIcon,
+                                      "NotificationAreaIcon")
+VENTUROUS_preferences_string_constant(startToNotificationArea,
+                                      "StartToNotificationArea")
+VENTUROUS_preferences_string_constant(closeToNotificationArea,
+                                      "CloseToNotificationArea")
+VENTUROUS_preferences_string_constant(statusBar, "StatusBar")
+VENTUROUS_preferences_string_constant(treeAutoUnfoldedLevels,
+                                      "TreeAutoUnfoldedLevels")
+VENTUROUS_preferences_string_constant(treeAutoCleanup, "TreeAutoCleanup")
+VENTUROUS_preferences_string_constant(savePreferencesToDiskImmediately,
+                                      "SavePreferencesToDiskImmediately")
+VENTUROUS_preferences_string_constant(ventoolCheckInterval,
+                                      "VentoolCheckInterval")
+VENTUROUS_preferences_string_constant(customActionsMaxParallel,
+                                      "CustomActionsMaxParallel")
+
+VENTUROUS_preferences_string_constant(preferencesWindowGeometry,
+                                      "PreferencesWindowGeometry")
+VENTUROUS_preferences_string_constant(windowGeometry, "WindowGeometry")
+VENTUROUS_preferences_string_constant(windowState, "WindowState")
+
+# undef VENTUROUS_preferences_string_constant
+} // END namespace PreferencesXmlNames
+
+# endif // VENTUROUS_PREFERENCES_XML_NAMES_HPP
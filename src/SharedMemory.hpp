@@ -21,6 +21,8 @@
 
 # include <QString>
 # include <QDir>
+# include <QFile>
+# include <QIODevice>
 # include <QSharedMemory>
 
 
@@ -40,6 +42,14 @@ inline QString key() {
     return "venturousandventoolhJkNQqC{" + getVenturousPreferencesDirName();
 }
 
+/// @return Path to the file that is modified after each command is written to
+/// shared memory. Watching this file lets the running instance react to
+/// commands immediately rather than on the next periodic check.
+inline QString commandNotificationFilename()
+{
+    return getVenturousPreferencesDirName() + "ventool-command";
+}
+
 namespace Symbol
 {
 constexpr char noCommand() noexcept { return 0; }
@@ -52,6 +62,7 @@ constexpr char nextFromHistory() noexcept { return 'T'; }
 constexpr char nextRandom() noexcept { return 'R'; }
 constexpr char next() noexcept { return 'N'; }
 constexpr char playAll() noexcept { return 'A'; }
+constexpr char playRandomBatch() noexcept { return 'B'; }
 constexpr char showExternal() noexcept { return 'E'; }
 constexpr char hideExternal() noexcept { return 'X'; }
 constexpr char setExternalOptions() noexcept { return 'O'; }
@@ -62,11 +73,21 @@ constexpr char quit() noexcept { return 'Q'; }
 
 } // END namespace Symbol
 
+/// @brief Modifies command notification file if it exists.
+inline void notifyCommandIssued()
+{
+    QFile file(commandNotificationFilename());
+    if (file.exists() && file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        file.write("!", 1);
+}
+
 inline void setSymbol(QSharedMemory & shared, char symbol)
 {
     shared.lock();
     *static_cast<char *>(shared.data()) = symbol;
     shared.unlock();
+    if (symbol != Symbol::noCommand())
+        notifyCommandIssued();
 }
 
 } // END namespace SharedMemory
@@ -40,6 +40,9 @@ constexpr const char * nextFromHistory() noexcept {
 constexpr const char * nextRandom() noexcept { return "next-random"; }
 constexpr const char * next() noexcept { return "next"; }
 constexpr const char * playAll() noexcept { return "play-all"; }
+constexpr const char * playRandomBatch() noexcept {
+    return "play-random-batch";
+}
 constexpr const char * showExternal() noexcept { return "show-external"; }
 constexpr const char * hideExternal() noexcept { return "hide-external"; }
 constexpr const char * setExternalOptions() noexcept {
@@ -76,6 +79,7 @@ void printHelp()
     printCommand(nextRandom(), "plays random item");
     printCommand(next(), "plays next item");
     printCommand(playAll(), "plays all playable items");
+    printCommand(playRandomBatch(), "plays several random items at once");
     printCommand(showExternal(), "shows external player");
     printCommand(hideExternal(), "hides external player");
     printCommand(setExternalOptions(),
@@ -132,6 +136,8 @@ int main(int argc, char * argv[])
             symbol = Symbol::next();
         else if (arg == playAll())
             symbol = Symbol::playAll();
+        else if (arg == playRandomBatch())
+            symbol = Symbol::playRandomBatch();
         else if (arg == showExternal())
             symbol = Symbol::showExternal();
         else if (arg == hideExternal())